@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "dominanceindex.h"
+#include "solvecontext.h"
+#include "tokenautomaton.h"
+
+// Library entry points for each day's solver.
+// Every solver takes the puzzle input as an in-memory buffer and does no I/O of its own.
+// Solvers that can run for a long time also take a SolveContext, for cancellation and progress reporting.
+
+namespace aoc
+{
+	template <typename T = uint64_t>
+	struct Answers
+	{
+		T partOne = 0;
+		T partTwo = 0;
+
+		bool operator==(const Answers&) const = default;
+	};
+
+	// Part one only considers digits, part two also considers spelled out numbers.
+	Answers<> solveDay01(std::string_view input);
+	// Day 01 with a vocabulary other than the puzzle's, e.g., another language's numbers, compiled
+	// into automata when called. Part one only considers the tokens made only of digits.
+	Answers<> solveDay01(std::string_view input, std::span<const Token> vocabulary);
+	Answers<> solveDay02(std::string_view input);
+	// Folds day 02's answers a line at a time, for logs read as they arrive rather than held in memory.
+	class Day02Stream
+	{
+	public:
+		Day02Stream();
+		~Day02Stream();
+
+		void addLine(std::string_view line);
+		Answers<> getAnswers() const;
+
+		class Sums;
+
+	private:
+		std::unique_ptr<Sums> sums;
+	};
+
+	// Day 02's answers for one piece of a log, or none if the piece shows colours other than the puzzle's,
+	// as then every game's power depends on the colours in the rest of the log.
+	std::optional<Answers<>> solveDay02Piece(std::string_view piece);
+	// For each bag of { red, green, blue } cubes, the number of day 02's games possible with it and the sum of their IDs.
+	std::vector<DominanceTotals> solveDay02Bags(std::string_view input, std::span<const std::array<uint64_t, 3>> bags);
+	Answers<> solveDay03(std::string_view input);
+	// Solves day 03 a row at a time, holding only the rows either side of the one being settled,
+	// for schematics read as they arrive rather than held in memory.
+	class Day03Stream
+	{
+	public:
+		Day03Stream();
+		~Day03Stream();
+
+		void addLine(std::string_view line);
+		Answers<> getAnswers() const;
+
+		class Window;
+
+	private:
+		std::unique_ptr<Window> window;
+	};
+
+	// A symbol in day 03's schematic, with the sum of the values of the parts next to it.
+	struct SymbolTotal
+	{
+		char symbol = 0;
+		size_t x = 0;
+		size_t y = 0;
+		uint64_t partSum = 0;
+
+		bool operator==(const SymbolTotal&) const = default;
+	};
+
+	// Day 03's adjacency between parts and symbols, built once to answer queries beyond the puzzle's,
+	// each from tables rather than another pass over the schematic. It doesn't keep the input.
+	class Day03Index
+	{
+	public:
+		// Matches symbols of every class.
+		static constexpr char AnySymbol = 0;
+
+		explicit Day03Index(std::string_view input);
+		~Day03Index();
+
+		// The distinct symbols in the schematic, in ascending order.
+		std::string_view getSymbolClasses() const;
+
+		// Sum of the parts next to at least one of the symbol. Part one is sumPartsNextTo(AnySymbol).
+		uint64_t sumPartsNextTo(char symbol) const;
+		// Sum, over each of the symbol with exactly numParts parts next to it, of the product of those
+		// parts' values, wrapping on overflow. Part two is sumPartProducts('*', 2).
+		uint64_t sumPartProducts(char symbol, size_t numParts) const;
+		// The symbols with the greatest part sums, greatest first, ties in reading order.
+		std::vector<SymbolTotal> getTopSymbols(size_t count) const;
+
+		class Index;
+
+	private:
+		std::unique_ptr<Index> index;
+	};
+
+	Answers<> solveDay04(std::string_view input);
+	Answers<> solveDay05(std::string_view input);
+	Answers<> solveDay06(std::string_view input);
+	Answers<> solveDay07(std::string_view input);
+	Answers<> solveDay08(std::string_view input, const SolveContext& context = {});
+	Answers<int> solveDay09(std::string_view input);
+	Answers<> solveDay10(std::string_view input);
+	Answers<int64_t> solveDay11(std::string_view input, int64_t pt1EmptyScale = 2, int64_t pt2EmptyScale = 1'000'000);
+	Answers<> solveDay12(std::string_view input, const SolveContext& context = {});
+	Answers<> solveDay13(std::string_view input);
+	Answers<> solveDay14(std::string_view input, const SolveContext& context = {});
+	Answers<> solveDay15(std::string_view input);
+	Answers<> solveDay16(std::string_view input, const SolveContext& context = {});
+}
@@ -0,0 +1,72 @@
+#include "benchmarks.h"
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+#include "gridtransform.h"
+
+// Repeats the kernel until enough time has passed to trust the measurement, and returns GB/s.
+static double measureThroughput(size_t bytes, const std::function<void()>& kernel)
+{
+	using Clock = std::chrono::steady_clock;
+
+	const auto minDuration = std::chrono::milliseconds(100);
+	const auto start = Clock::now();
+
+	size_t runs = 0;
+	do
+	{
+		kernel();
+		++runs;
+	}
+	while (Clock::now() - start < minDuration);
+
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	return (double) (bytes * runs) / seconds / 1e9;
+}
+
+void aoc::benchmarkGridTransforms()
+{
+	struct Shape
+	{
+		size_t width;
+		size_t height;
+	};
+
+	// Day 13 and 14 sized grids, then larger ones that no longer fit in cache, square and not.
+	static constexpr Shape shapes[] =
+	{
+		{ 17, 13 },
+		{ 100, 100 },
+		{ 1000, 1000 },
+		{ 4096, 4096 },
+		{ 5000, 700 },
+		{ 333, 7777 },
+	};
+
+	std::printf("%-12s %12s %12s %12s %12s\n", "Grid", "naive GB/s", "transpose", "clockwise", "anticlock");
+
+	for (const Shape& shape : shapes)
+	{
+		const size_t size = shape.width * shape.height;
+
+		std::string source(size, '.');
+		for (size_t i = 0; i < size; i += 3)
+			source[i] = '#';
+
+		std::string dest(size, ' ');
+
+		const ConstByteGrid src = { source.data(), shape.width, shape.height, (ptrdiff_t) shape.width };
+		const ByteGrid dst = { dest.data(), shape.height, shape.width, (ptrdiff_t) shape.height };
+
+		const double naive = measureThroughput(size, [&] { transposeNaive(src, dst); });
+		const double blocked = measureThroughput(size, [&] { transpose(src, dst); });
+		const double clockwise = measureThroughput(size, [&] { rotateClockwise(src, dst); });
+		const double anticlockwise = measureThroughput(size, [&] { rotateAnticlockwise(src, dst); });
+
+		const std::string name = std::to_string(shape.width) + "x" + std::to_string(shape.height);
+		std::printf("%-12s %12.2f %12.2f %12.2f %12.2f\n", name.c_str(), naive, blocked, clockwise, anticlockwise);
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace aoc
+{
+	// Times the grid transform kernels against an element by element copy, over a range of
+	// grid shapes, and prints the throughput of each.
+	void benchmarkGridTransforms();
+}
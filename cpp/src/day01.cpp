@@ -1,12 +1,22 @@
 #include <algorithm>
+#include <array>
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
 
-static const std::vector<std::pair<std::string, int>> numberStrings =
-{
+#include "aoc.h"
+#include "dispatch.h"
+#include "input.h"
+#include "shard.h"
+#include "tokenautomaton.h"
+
+#if defined(AOC_X86)
+#include <immintrin.h>
+#endif
+
+static constexpr std::array<aoc::Token, 20> numberStrings =
+{{
 	{ "0", 0 },
 	{ "1", 1 },
 	{ "2", 2 },
@@ -27,7 +37,21 @@ static const std::vector<std::pair<std::string, int>> numberStrings =
 	{ "seven",  7 },
 	{ "eight",  8 },
 	{ "nine",   9 },
-};
+}};
+
+// The first ten number strings are the digits themselves.
+static constexpr std::array<aoc::Token, 10> digitStrings = []
+{
+	std::array<aoc::Token, 10> digits;
+	std::copy_n(begin(numberStrings), digits.size(), begin(digits));
+	return digits;
+}();
+
+static constexpr auto digitAutomaton = aoc::compileTokenAutomaton<digitStrings>();
+static constexpr auto numberAutomaton = aoc::compileTokenAutomaton<numberStrings>();
+
+static constexpr auto digitAutomatonReversed = aoc::compileTokenAutomaton<digitStrings, aoc::MatchDirection::Backward>();
+static constexpr auto numberAutomatonReversed = aoc::compileTokenAutomaton<numberStrings, aoc::MatchDirection::Backward>();
 
 enum class ConsiderText
 {
@@ -35,56 +59,346 @@ enum class ConsiderText
 	True
 };
 
-static int process(const char* filename, ConsiderText considerTextMode)
+// Scans each line once from start to end.
+static constexpr uint64_t sumSinglePass(std::string_view input, const auto& automaton)
 {
-	std::fstream s{filename, s.in};
-	assert(s.is_open());
+	uint64_t sum = 0;
+
+	for (const std::string_view line : aoc::lines(input))
+	{
+		assert(line.size() > 0);
+
+		const aoc::FirstAndLastTokens tokens = aoc::findFirstAndLastTokens(automaton, line);
+
+		// Lines without any numbers don't contribute, e.g., part one on a line of only spelled out numbers.
+		if (!tokens.first.found())
+			continue;
+
+		const int num = (tokens.first.value * 10) + tokens.last.value;
+		sum += num;
+	}
 
-	int sum = 0;
+	return sum;
+}
+
+// Scans each line forward until its first number, then backward from its end until its last,
+// leaving the middle of long lines untouched.
+static constexpr uint64_t sumBidirectional(std::string_view input, const auto& automaton, const auto& reversedAutomaton)
+{
+	uint64_t sum = 0;
 
-	while (s.peek() != EOF)
+	for (const std::string_view line : aoc::lines(input))
 	{
-		std::string line;
-		std::getline(s, line);
 		assert(line.size() > 0);
 
-		std::vector<std::pair<int, size_t>> numbersAtPositions;
+		const aoc::TokenAt first = aoc::findFirstToken(automaton, line);
 
-		for (const auto& toFind : numberStrings)
-		{
-			if (considerTextMode == ConsiderText::False && toFind.first.size() != 1)
-				continue;
+		// Lines without any numbers don't contribute, e.g., part one on a line of only spelled out numbers.
+		if (!first.token.found())
+			continue;
+
+		// The last number can't start before the first.
+		const aoc::TokenAt last = aoc::findLastToken(reversedAutomaton, line.substr(first.position));
+
+		const int num = (first.token.value * 10) + last.token.value;
+		sum += num;
+	}
+
+	return sum;
+}
+
+static constexpr uint64_t processSinglePass(std::string_view input, ConsiderText considerTextMode)
+{
+	return considerTextMode == ConsiderText::True
+		? sumSinglePass(input, numberAutomaton)
+		: sumSinglePass(input, digitAutomaton);
+}
+
+static constexpr uint64_t processBidirectional(std::string_view input, ConsiderText considerTextMode)
+{
+	return considerTextMode == ConsiderText::True
+		? sumBidirectional(input, numberAutomaton, numberAutomatonReversed)
+		: sumBidirectional(input, digitAutomaton, digitAutomatonReversed);
+}
+
+static constexpr void accumulate(uint64_t& total, uint64_t chunk)
+{
+	total += chunk;
+}
+
+static constexpr void accumulate(aoc::Answers<>& total, const aoc::Answers<>& chunk)
+{
+	total.partOne += chunk.partOne;
+	total.partTwo += chunk.partTwo;
+}
+
+// Lines are independent, so each of a chunk of lines per hardware thread is summed by a serial kernel,
+// and the partial sums added up.
+template <auto SumChunk, typename... Args>
+static auto sumInParallel(std::string_view input, Args... args)
+{
+	using Sum = decltype(SumChunk(input, args...));
+
+	const std::vector<Sum> partialSums = aoc::solveChunksInParallel(input, [&] (std::string_view chunk) { return SumChunk(chunk, args...); });
+
+	Sum total = {};
+
+	for (const Sum& partialSum : partialSums)
+		accumulate(total, partialSum);
+
+	return total;
+}
+
+// Below this, starting threads costs more than it saves.
+static constexpr size_t MinParallelInputSize = size_t(1) << 20;
 
-			const size_t firstPos = line.find(toFind.first);
-			if (firstPos == std::string::npos)
-				continue;
+static const aoc::KernelSet<uint64_t(std::string_view, ConsiderText)> processKernels(1, "day01.numbers",
+{
+	{ { .name = "parallel", .multithreaded = true, .minInputSize = MinParallelInputSize }, &sumInParallel<&processBidirectional, ConsiderText> },
+	{ { .name = "bidirectional" }, &processBidirectional },
+	{ { .name = "singlePass" }, &processSinglePass },
+});
+
+// Finding only digits needs no automaton, so digits only mode scans the whole buffer at once,
+// carrying the current line's first and last digits across blocks and line breaks.
+struct DigitScan
+{
+	uint64_t sum = 0;
+	int first = -1;
+	int last = -1;
+
+	constexpr void addDigit(char c)
+	{
+		if (first < 0)
+			first = c - '0';
+
+		last = c - '0';
+	}
+
+	// Lines without any digits don't contribute.
+	constexpr void endLine()
+	{
+		if (first >= 0)
+			sum += (first * 10) + last;
 
-			numbersAtPositions.emplace_back(toFind.second, firstPos);
+		first = -1;
+		last = -1;
+	}
 
-			const size_t lastPos = line.rfind(toFind.first);
-			if (firstPos != lastPos)
-				numbersAtPositions.emplace_back(toFind.second, lastPos);
+	constexpr void scan(std::string_view bytes)
+	{
+		for (const char c : bytes)
+		{
+			if (aoc::isDigit(c))
+				addDigit(c);
+			else if (c == '\n')
+				endLine();
 		}
+	}
+};
+
+static constexpr uint64_t sumDigitsScalar(std::string_view input)
+{
+	DigitScan digitScan;
+	digitScan.scan(input);
+	digitScan.endLine();
+	return digitScan.sum;
+}
+
+#if defined(AOC_X86)
+
+// Takes the first and last digits flagged in a 32 byte block's mask.
+AOC_TARGET_AVX2 static inline void addDigitsAvx2(DigitScan& digitScan, const char* block, uint32_t digits)
+{
+	if (digits == 0)
+		return;
+
+	if (digitScan.first < 0)
+		digitScan.first = block[_tzcnt_u32(digits)] - '0';
+
+	digitScan.last = block[31 - _lzcnt_u32(digits)] - '0';
+}
+
+// Classifies 32 bytes at a time into digit and newline masks, then walks the newlines
+// in each block, taking the first and last digit either side of them from the masks.
+AOC_TARGET_AVX2 static uint64_t sumDigitsAvx2(std::string_view input)
+{
+	const __m256i zeroChar = _mm256_set1_epi8('0');
+	const __m256i nine = _mm256_set1_epi8(9);
+	const __m256i newlineChar = _mm256_set1_epi8('\n');
+
+	DigitScan digitScan;
+
+	const char* data = input.data();
+	const size_t blocksEnd = input.size() - (input.size() % 32);
+
+	for (size_t i = 0; i < blocksEnd; i += 32)
+	{
+		const __m256i bytes = _mm256_loadu_si256((const __m256i*) (data + i));
+
+		// Digits are those bytes which, less '0', are at most 9 when compared unsigned.
+		const __m256i offsets = _mm256_sub_epi8(bytes, zeroChar);
+		uint32_t digits = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(offsets, nine), offsets));
+		uint32_t newlines = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newlineChar));
 
-		std::sort(begin(numbersAtPositions), end(numbersAtPositions), [] (const auto& lhs, const auto& rhs)
+		while (newlines != 0)
 		{
-			return lhs.second < rhs.second;
-		});
+			const uint32_t newline = _tzcnt_u32(newlines);
+			const uint32_t upToNewline = (2u << newline) - 1; // all bits at or below it, even for bit 31
 
-		const int first = numbersAtPositions.front().first;
-		const int last = numbersAtPositions.back().first;
+			addDigitsAvx2(digitScan, data + i, digits & upToNewline);
+			digitScan.endLine();
 
-		const int num = (first * 10) + last;
-		sum += num;
+			digits &= ~upToNewline;
+			newlines &= newlines - 1;
+		}
+
+		addDigitsAvx2(digitScan, data + i, digits);
 	}
 
-	return sum;
+	digitScan.scan(input.substr(blocksEnd));
+	digitScan.endLine();
+
+	return digitScan.sum;
+}
+
+#endif
+
+static const aoc::KernelSet<uint64_t(std::string_view)> digitKernels(1, "day01.digits",
+{
+#if defined(AOC_X86)
+	{ { .name = "parallelAvx2", .isa = aoc::Isa::Avx2, .multithreaded = true, .minInputSize = MinParallelInputSize }, &sumInParallel<&sumDigitsAvx2> },
+#endif
+	{ { .name = "parallel", .multithreaded = true, .minInputSize = MinParallelInputSize }, &sumInParallel<&sumDigitsScalar> },
+#if defined(AOC_X86)
+	{ { .name = "avx2", .isa = aoc::Isa::Avx2 }, &sumDigitsAvx2 },
+#endif
+	{ { .name = "scalar" }, &sumDigitsScalar },
+});
+
+static uint64_t process(std::string_view input, ConsiderText considerTextMode)
+{
+	if (considerTextMode == ConsiderText::False)
+		return digitKernels.select(input.size())(input);
+
+	return processKernels.select(input.size())(input, considerTextMode);
+}
+
+// Both modes from one forward and one backward scan of each line. Every digit is also a number,
+// so the first and last numbers are usually the first and last digits too. Only when they're
+// spelled out do the digits need looking for, and then only between the two.
+static constexpr aoc::Answers<> sumBoth(std::string_view input)
+{
+	aoc::Answers<> sums;
+
+	for (const std::string_view line : aoc::lines(input))
+	{
+		assert(line.size() > 0);
+
+		const aoc::TokenAt first = aoc::findFirstToken(numberAutomaton, line);
+
+		// Lines without any numbers have no digits either.
+		if (!first.token.found())
+			continue;
+
+		const aoc::TokenAt last = aoc::findLastToken(numberAutomatonReversed, line.substr(first.position));
+		const size_t lastPosition = first.position + last.position;
+
+		sums.partTwo += (first.token.value * 10) + last.token.value;
+
+		size_t firstDigit = first.position;
+		while (firstDigit < line.size() && !aoc::isDigit(line[firstDigit]))
+			++firstDigit;
+
+		// Lines of only spelled out numbers don't contribute to part one.
+		if (firstDigit == line.size())
+			continue;
+
+		size_t lastDigit = lastPosition;
+		while (!aoc::isDigit(line[lastDigit]))
+			--lastDigit;
+
+		sums.partOne += ((line[firstDigit] - '0') * 10) + (line[lastDigit] - '0');
+	}
+
+	return sums;
+}
+
+// Each mode with its own kernels.
+static aoc::Answers<> solveSeparately(std::string_view input)
+{
+	return { process(input, ConsiderText::False), process(input, ConsiderText::True) };
+}
+
+// Summing digits with AVX2 is fast enough that a separate pass for them beats the fused scan,
+// so solving separately is preferred where it's available.
+static const aoc::KernelSet<aoc::Answers<>(std::string_view)> solveKernels(1, "day01.solve",
+{
+	{ { .name = "parallelFused", .multithreaded = true, .minInputSize = MinParallelInputSize }, &sumInParallel<&sumBoth> },
+#if defined(AOC_X86)
+	{ { .name = "separate", .isa = aoc::Isa::Avx2 }, &solveSeparately },
+#endif
+	{ { .name = "fused" }, &sumBoth },
+});
+
+aoc::Answers<> aoc::solveDay01(std::string_view input)
+{
+	return solveKernels.select(input.size())(input);
+}
+
+static constexpr aoc::Answers<> sumWithVocabulary(std::string_view input, std::span<const aoc::Token> vocabulary)
+{
+	std::vector<aoc::Token> digitTokens;
+	std::copy_if(begin(vocabulary), end(vocabulary), back_inserter(digitTokens), [] (const aoc::Token& token)
+	{
+		return std::all_of(begin(token.text), end(token.text), aoc::isDigit);
+	});
+
+	const aoc::TokenAutomaton digits(digitTokens);
+	const aoc::TokenAutomaton digitsReversed(digitTokens, aoc::MatchDirection::Backward);
+	const aoc::TokenAutomaton numbers(vocabulary);
+	const aoc::TokenAutomaton numbersReversed(vocabulary, aoc::MatchDirection::Backward);
+
+	return { sumBidirectional(input, digits, digitsReversed), sumBidirectional(input, numbers, numbersReversed) };
 }
 
+aoc::Answers<> aoc::solveDay01(std::string_view input, std::span<const Token> vocabulary)
+{
+	return sumWithVocabulary(input, vocabulary);
+}
+
+// Copies of data/01/test.txt and test2.txt, checked at compile time.
+static constexpr std::string_view testInput =
+R"(1abc2
+pqr3stu8vwx
+a1b2c3d4e5f
+treb7uchet)";
+
+static constexpr std::string_view testInput2 =
+R"(two1nine
+eightwothree
+abcone2threexyz
+xtwone3four
+4nineeightseven2
+zoneight234
+7pqrstsixteen)";
+
+static_assert(processSinglePass(testInput, ConsiderText::False) == 142);
+static_assert(processSinglePass(testInput2, ConsiderText::True) == 281);
+static_assert(processBidirectional(testInput, ConsiderText::False) == 142);
+static_assert(processBidirectional(testInput2, ConsiderText::True) == 281);
+static_assert(sumDigitsScalar(testInput) == 142);
+static_assert(sumBoth(testInput) == aoc::Answers<>{ 142, 142 });
+static_assert(sumBoth(testInput2).partTwo == 281);
+static_assert(sumWithVocabulary(testInput2, numberStrings) == aoc::Answers<>{ 209, 281 });
+
+// Overlapping and multi-digit tokens, as a vocabulary file would give them.
+static_assert(sumWithVocabulary("un2deux\nzz12onze\n", aoc::parseTokens("un 1\ndeux 2\n12 5\n1 1\n2 2\nonze 9\n")) == aoc::Answers<>{ 22 + 52, 12 + 59 });
+
 void day01()
 {
-	assert(process("../data/01/test.txt", ConsiderText::False) == 142);
-	assert(process("../data/01/real.txt", ConsiderText::False) == 55816);
-	assert(process("../data/01/test2.txt", ConsiderText::True) == 281);
-	assert(process("../data/01/real.txt", ConsiderText::True) == 54980);
+	const std::string real = aoc::readFile("../data/01/real.txt");
+
+	assert(aoc::solveDay01(real) == aoc::Answers<>(55816, 54980));
+	assert(aoc::solveDay01(real, numberStrings) == aoc::Answers<>(55816, 54980));
 }
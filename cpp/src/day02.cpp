@@ -1,137 +1,632 @@
 #include <algorithm>
+#include <array>
 #include <cassert>
-#include <fstream>
 #include <iostream>
-#include <numeric>
+#include <memory>
 #include <optional>
-#include <ranges>
+#include <span>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include "aoc.h"
+#include "dispatch.h"
+#include "input.h"
+#include "shard.h"
+
+#if defined(AOC_X86)
+#include <immintrin.h>
+#endif
+
+// The puzzle's colours, in the order of their columns. Inputs can show others, which are discovered
+// as they're parsed, though the common case of only these three is specialized to stay fast.
+static constexpr std::array<std::string_view, 3> PuzzleColours = { "red", "green", "blue" };
+static constexpr size_t Red = 0;
+static constexpr size_t Green = 1;
+static constexpr size_t Blue = 2;
+
+// Number of colours for when they're discovered from the input rather than known at compile time.
+static constexpr size_t AnyColours = 0;
+
+template <size_t NumColours, typename T>
+using PerColour = std::conditional_t<NumColours == AnyColours, std::vector<T>, std::array<T, NumColours>>;
+
+// Numbers of cubes of each colour, in palette order. Colours never shown have none.
+template <size_t NumColours>
 struct Set
 {
-	uint64_t red = 0;
-	uint64_t green = 0;
-	uint64_t blue = 0;
+	PerColour<NumColours, uint64_t> counts = {};
+
+	constexpr uint64_t count(size_t colour) const { return colour < counts.size() ? counts[colour] : 0; }
 
-	bool isPossible(const Set& maxSet) const
+	constexpr void setCount(size_t colour, uint64_t count)
 	{
-		return red <= maxSet.red
-			&& green <= maxSet.green
-			&& blue <= maxSet.blue;
+		if constexpr (NumColours == AnyColours)
+			if (colour >= counts.size())
+				counts.resize(colour + 1, 0);
+
+		counts[colour] = count;
 	}
 
-	uint64_t getPower() const { return red * green * blue; }
+	constexpr bool isPossible(const Set& maxSet) const
+	{
+		for (size_t colour = 0; colour < counts.size(); ++colour)
+			if (counts[colour] > maxSet.count(colour))
+				return false;
+
+		return true;
+	}
+
+	constexpr uint64_t getPower(size_t numColours) const
+	{
+		uint64_t power = 1;
+
+		for (size_t colour = 0; colour < numColours; ++colour)
+			power *= count(colour);
+
+		return power;
+	}
+};
+
+template <size_t NumColours>
+static constexpr Set<NumColours> getPuzzleBag()
+{
+	Set<NumColours> bag;
+	bag.setCount(Red, 12);
+	bag.setCount(Green, 13);
+	bag.setCount(Blue, 14);
+	return bag;
+}
+
+// Colour names in the order they were first seen, after the puzzle's own.
+// Names are copied, as streamed lines needn't outlive the call passing them in.
+struct Palette
+{
+	std::vector<std::string> names = { begin(PuzzleColours), end(PuzzleColours) };
+
+	constexpr size_t indexOf(std::string_view name)
+	{
+		const auto it = std::find(begin(names), end(names), name);
+		if (it != end(names))
+			return (size_t) (it - begin(names));
+
+		names.emplace_back(name);
+		return names.size() - 1;
+	}
 };
 
+// Both parts only depend on the most cubes of each colour shown at once,
+// so sets are folded into that as they're parsed rather than kept.
+template <size_t NumColours>
 struct Game02
 {
 	uint64_t id = 0;
-	std::vector<Set> sets;
+	Set<NumColours> minPossibleSet;
 
-	Set getMinPossibleSet() const
+	constexpr void addSet(const Set<NumColours>& set)
 	{
-		return std::accumulate(begin(sets), end(sets), Set(), [] (Set minSet, const Set& set) -> Set
-		{
-			return
-			{
-				std::max(minSet.red, set.red),
-				std::max(minSet.green, set.green),
-				std::max(minSet.blue, set.blue),
-			};
-		});
+		for (size_t colour = 0; colour < set.counts.size(); ++colour)
+			minPossibleSet.setCount(colour, std::max(minPossibleSet.count(colour), set.counts[colour]));
 	}
 };
 
-static Game02 parseGame(const std::string& gameString)
+static constexpr void skip(std::string_view& str, std::string_view expected)
 {
-	Game02 game;
-	game.sets.push_back({});
+	assert(str.starts_with(expected));
+	str.remove_prefix(expected.size());
+}
 
-	uint64_t currentNum = 0;
+// Reads "Game N: " then "count colour" pairs, separated by ", " within a set and "; " between sets,
+// in one pass over the line's bytes.
+//
+// With three colours, they're told apart by their first letter, and empty is returned for lines
+// showing any other colour. Otherwise colours are looked up in, or added to, the palette.
+template <size_t NumColours>
+static constexpr std::optional<Game02<NumColours>> parseGame(std::string_view line, [[maybe_unused]] Palette& palette)
+{
+	Game02<NumColours> game;
 
-	for (const auto word : std::views::split(gameString, ' '))
+	skip(line, "Game ");
+	game.id = (uint64_t) aoc::consumeNumber(line);
+	skip(line, ": ");
+
+	Set<NumColours> set;
+
+	while (!line.empty())
 	{
-		const std::string token(&*word.begin(), std::ranges::distance(word));
+		const uint64_t count = (uint64_t) aoc::consumeNumber(line);
+		skip(line, " ");
 
-		Set& set = game.sets.back();
+		size_t colour = 0;
 
-		if (token == "Game02")
-			continue;
-		else if (game.id == 0)
-			game.id = std::stoull(token);
-		else if (std::isdigit(token.front()))
-			currentNum = std::stoull(token);
-		else if (token.find("red") != std::string::npos)
-			set.red = currentNum;
-		else if (token.find("green") != std::string::npos)
-			set.green = currentNum;
-		else if (token.find("blue") != std::string::npos)
-			set.blue = currentNum;
+		if constexpr (NumColours == 3)
+		{
+			colour = (line.front() == 'r') ? Red : (line.front() == 'g') ? Green : Blue;
+
+			const std::string_view name = PuzzleColours[colour];
+			if (!line.starts_with(name) || (line.size() > name.size() && line[name.size()] != ',' && line[name.size()] != ';'))
+				return {};
+
+			line.remove_prefix(name.size());
+		}
 		else
-			assert(false);
+		{
+			size_t nameEnd = 0;
+			while (nameEnd < line.size() && line[nameEnd] != ',' && line[nameEnd] != ';')
+				++nameEnd;
+
+			colour = palette.indexOf(line.substr(0, nameEnd));
+			line.remove_prefix(nameEnd);
+		}
+
+		set.setCount(colour, count);
 
-		if (token.back() == ';')
-			game.sets.push_back({});
+		if (line.empty() || line.front() == ';')
+		{
+			game.addSet(set);
+			std::fill(begin(set.counts), end(set.counts), 0);
+		}
+
+		if (!line.empty())
+			line.remove_prefix(2);
 	}
 
 	return game;
 }
 
-static std::vector<Game02> loadGames(const char* filename)
+// Games are stored a column per field rather than a struct per game, so that the parts'
+// reductions can work on eight games per instruction.
+template <size_t NumColours>
+struct Games02
 {
-	std::vector<Game02> games;
+	std::vector<uint32_t> ids;
+	std::vector<std::vector<uint32_t>> colours = std::vector<std::vector<uint32_t>>(NumColours);
+
+	constexpr size_t size() const { return ids.size(); }
+	constexpr size_t getNumColours() const { return (NumColours == AnyColours) ? colours.size() : NumColours; }
+
+	constexpr void add(const Game02<NumColours>& game, size_t numColours)
+	{
+		// Colours first seen in this game have none in all the games before it.
+		if constexpr (NumColours == AnyColours)
+			while (colours.size() < numColours)
+				colours.emplace_back(ids.size(), 0);
+
+		assert(game.id <= UINT32_MAX);
+		ids.push_back((uint32_t) game.id);
+
+		for (size_t colour = 0; colour < getNumColours(); ++colour)
+		{
+			assert(game.minPossibleSet.count(colour) <= UINT32_MAX);
+			colours[colour].push_back((uint32_t) game.minPossibleSet.count(colour));
+		}
+	}
+
+	constexpr Set<NumColours> getMinPossibleSet(size_t game) const
+	{
+		Set<NumColours> set;
+
+		for (size_t colour = 0; colour < getNumColours(); ++colour)
+			set.setCount(colour, colours[colour][game]);
 
-	std::fstream s{ filename, s.in };
-	assert(s.is_open());
+		return set;
+	}
+};
+
+// Empty if the input shows colours other than the puzzle's and NumColours is 3.
+template <size_t NumColours>
+static constexpr std::optional<Games02<NumColours>> loadGames(std::string_view input)
+{
+	Games02<NumColours> games;
+	Palette palette;
 
-	while (s.peek() != EOF)
+	for (const std::string_view line : aoc::lines(input))
 	{
-		std::string line;
-		std::getline(s, line);
 		assert(line.size() > 0);
 
-		games.push_back(parseGame(line));
-		assert(games.back().id == games.size());
+		const std::optional<Game02<NumColours>> game = parseGame<NumColours>(line, palette);
+		if (!game)
+			return {};
+
+		games.add(*game, palette.names.size());
+
+		// IDs run consecutively, though may not start at 1 when solving a shard of a larger input.
+		assert(games.size() == 1 || games.ids.back() == games.ids[games.size() - 2] + 1);
 	}
 
 	return games;
 }
 
-static uint64_t partOne(const std::vector<Game02>& games)
+template <size_t NumColours>
+static constexpr uint64_t sumPossibleIdsScalar(const Games02<NumColours>& games, const Set<NumColours>& bag)
+{
+	uint64_t sum = 0;
+
+	for (size_t i = 0; i < games.size(); ++i)
+	{
+		bool possible = true;
+
+		for (size_t colour = 0; colour < games.getNumColours(); ++colour)
+			possible = possible && games.colours[colour][i] <= bag.count(colour);
+
+		sum += games.ids[i] * possible;
+	}
+
+	return sum;
+}
+
+template <size_t NumColours>
+static constexpr uint64_t sumPowersScalar(const Games02<NumColours>& games)
+{
+	uint64_t sum = 0;
+
+	for (size_t i = 0; i < games.size(); ++i)
+	{
+		uint64_t power = 1;
+
+		for (size_t colour = 0; colour < games.getNumColours(); ++colour)
+			power *= games.colours[colour][i];
+
+		sum += power;
+	}
+
+	return sum;
+}
+
+#if defined(AOC_X86)
+
+// Reads the last two lanes back through memory, as the 64-bit lane extracts don't exist in 32-bit builds.
+AOC_TARGET_AVX2 static inline uint64_t horizontalSum(__m256i sums)
+{
+	const __m128i pairs = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+
+	uint64_t lanes[2] = {};
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), pairs);
+	return lanes[0] + lanes[1];
+}
+
+// Masks out the IDs of games needing more of any colour than the bag holds, and sums the rest in 64-bit lanes.
+AOC_TARGET_AVX2 static uint64_t sumPossibleIdsAvx2(const Games02<3>& games, const Set<3>& bag)
+{
+	// Bags holding more than any game could need are clamped, which doesn't change which games are possible.
+	const __m256i maxRed = _mm256_set1_epi32((int) (uint32_t) std::min<uint64_t>(bag.counts[Red], UINT32_MAX));
+	const __m256i maxGreen = _mm256_set1_epi32((int) (uint32_t) std::min<uint64_t>(bag.counts[Green], UINT32_MAX));
+	const __m256i maxBlue = _mm256_set1_epi32((int) (uint32_t) std::min<uint64_t>(bag.counts[Blue], UINT32_MAX));
+
+	__m256i sums = _mm256_setzero_si256();
+
+	const size_t blocksEnd = games.size() - (games.size() % 8);
+
+	for (size_t i = 0; i < blocksEnd; i += 8)
+	{
+		const __m256i red = _mm256_loadu_si256((const __m256i*) (games.colours[Red].data() + i));
+		const __m256i green = _mm256_loadu_si256((const __m256i*) (games.colours[Green].data() + i));
+		const __m256i blue = _mm256_loadu_si256((const __m256i*) (games.colours[Blue].data() + i));
+		const __m256i ids = _mm256_loadu_si256((const __m256i*) (games.ids.data() + i));
+
+		// Unsigned a <= b is min(a, b) == a.
+		const __m256i possible = _mm256_and_si256(
+			_mm256_and_si256(_mm256_cmpeq_epi32(_mm256_min_epu32(red, maxRed), red), _mm256_cmpeq_epi32(_mm256_min_epu32(green, maxGreen), green)),
+			_mm256_cmpeq_epi32(_mm256_min_epu32(blue, maxBlue), blue));
+
+		const __m256i possibleIds = _mm256_and_si256(ids, possible);
+
+		sums = _mm256_add_epi64(sums, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(possibleIds)));
+		sums = _mm256_add_epi64(sums, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(possibleIds, 1)));
+	}
+
+	uint64_t sum = horizontalSum(sums);
+
+	for (size_t i = blocksEnd; i < games.size(); ++i)
+		sum += games.ids[i] * games.getMinPossibleSet(i).isPossible(bag);
+
+	return sum;
+}
+
+// 64-bit lanes of a by the low 32 bits of b's 64-bit lanes, keeping the low 64 bits of each product.
+AOC_TARGET_AVX2 static inline __m256i multiplyBy32(__m256i a, __m256i b)
+{
+	const __m256i low = _mm256_mul_epu32(a, b);
+	const __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+	return _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+}
+
+// Multiplies red by green into 64-bit lanes, even and odd games separately, then by blue as a 64 by 32-bit
+// multiply from two 32-bit halves, wrapping the same as the scalar kernel would.
+AOC_TARGET_AVX2 static uint64_t sumPowersAvx2(const Games02<3>& games)
+{
+	__m256i sums = _mm256_setzero_si256();
+
+	const size_t blocksEnd = games.size() - (games.size() % 8);
+
+	for (size_t i = 0; i < blocksEnd; i += 8)
+	{
+		const __m256i red = _mm256_loadu_si256((const __m256i*) (games.colours[Red].data() + i));
+		const __m256i green = _mm256_loadu_si256((const __m256i*) (games.colours[Green].data() + i));
+		const __m256i blue = _mm256_loadu_si256((const __m256i*) (games.colours[Blue].data() + i));
+
+		// _mm256_mul_epu32 multiplies the even 32-bit lanes, so shifting down by 32 bits gives the odd ones.
+		const __m256i evenPowers = multiplyBy32(_mm256_mul_epu32(red, green), blue);
+		const __m256i oddPowers = multiplyBy32(_mm256_mul_epu32(_mm256_srli_epi64(red, 32), _mm256_srli_epi64(green, 32)), _mm256_srli_epi64(blue, 32));
+
+		sums = _mm256_add_epi64(sums, _mm256_add_epi64(evenPowers, oddPowers));
+	}
+
+	uint64_t sum = horizontalSum(sums);
+
+	for (size_t i = blocksEnd; i < games.size(); ++i)
+		sum += games.getMinPossibleSet(i).getPower(3);
+
+	return sum;
+}
+
+#endif
+
+static const aoc::KernelSet<uint64_t(const Games02<3>&, const Set<3>&)> possibleIdsKernels(2, "day02.possibleIds",
+{
+#if defined(AOC_X86)
+	{ { .name = "avx2", .isa = aoc::Isa::Avx2 }, &sumPossibleIdsAvx2 },
+#endif
+	{ { .name = "scalar" }, &sumPossibleIdsScalar<3> },
+});
+
+static const aoc::KernelSet<uint64_t(const Games02<3>&)> powersKernels(2, "day02.powers",
+{
+#if defined(AOC_X86)
+	{ { .name = "avx2", .isa = aoc::Isa::Avx2 }, &sumPowersAvx2 },
+#endif
+	{ { .name = "scalar" }, &sumPowersScalar<3> },
+});
+
+// Inputs showing other colours than the puzzle's fall back to discovering them as they're parsed.
+static constexpr aoc::Answers<> processAnyColours(std::string_view input)
+{
+	const Games02<AnyColours> games = *loadGames<AnyColours>(input);
+	return { sumPossibleIdsScalar(games, getPuzzleBag<AnyColours>()), sumPowersScalar(games) };
+}
+
+static constexpr aoc::Answers<> processScalar(std::string_view input)
+{
+	if (const std::optional<Games02<3>> games = loadGames<3>(input))
+		return { sumPossibleIdsScalar(*games, getPuzzleBag<3>()), sumPowersScalar(*games) };
+
+	return processAnyColours(input);
+}
+
+static aoc::Answers<> solveColumnar(std::string_view input)
+{
+	if (const std::optional<Games02<3>> games = loadGames<3>(input))
+		return { possibleIdsKernels.select(games->size())(*games, getPuzzleBag<3>()), powersKernels.select(games->size())(*games) };
+
+	return processAnyColours(input);
+}
+
+// Folds both answers a line at a time, keeping nothing per game, so memory stays constant however
+// long the log. Until a line shows another colour, lines take the 3-colour parser.
+struct GameLogSums
+{
+	Palette palette;
+	Set<AnyColours> anyColoursBag = getPuzzleBag<AnyColours>();
+	aoc::Answers<> sums;
+
+	constexpr bool hasOnlyPuzzleColours() const { return palette.names.size() == PuzzleColours.size(); }
+
+	constexpr void addLine(std::string_view line)
+	{
+		assert(line.size() > 0);
+
+		if (hasOnlyPuzzleColours())
+		{
+			if (const std::optional<Game02<3>> game = parseGame<3>(line, palette))
+			{
+				sums.partOne += game->id * game->minPossibleSet.isPossible(getPuzzleBag<3>());
+				sums.partTwo += game->minPossibleSet.getPower(3);
+				return;
+			}
+		}
+
+		const size_t numColours = palette.names.size();
+		const Game02<AnyColours> game = *parseGame<AnyColours>(line, palette);
+
+		// None of the games before a colour first appears showed it, so none of them have any power.
+		if (palette.names.size() > numColours)
+			sums.partTwo = 0;
+
+		sums.partOne += game.id * game.minPossibleSet.isPossible(anyColoursBag);
+		sums.partTwo += game.minPossibleSet.getPower(palette.names.size());
+	}
+};
+
+static constexpr GameLogSums sumGameLog(std::string_view input)
+{
+	GameLogSums gameLogSums;
+
+	for (const std::string_view line : aoc::lines(input))
+		gameLogSums.addLine(line);
+
+	return gameLogSums;
+}
+
+static constexpr aoc::Answers<> solveStreaming(std::string_view input)
+{
+	return sumGameLog(input).sums;
+}
+
+// Chunks of lines are folded on separate threads. A chunk's powers depend on every colour in the log,
+// so if any chunk shows colours other than the puzzle's, the log is folded again in one piece.
+static aoc::Answers<> solveStreamingInParallel(std::string_view input)
 {
-	static constexpr Set maxSet = { 12, 13, 14 };
-	static constexpr auto isPossible = [] (const Set& set) { return set.isPossible(maxSet); };
+	const std::vector<GameLogSums> chunks = aoc::solveChunksInParallel(input, sumGameLog);
+
+	aoc::Answers<> sums;
 
-	return std::accumulate(begin(games), end(games), 0ull, [] (uint64_t sum, const Game02& game)
+	for (const GameLogSums& chunk : chunks)
 	{
-		return sum + (game.id * std::all_of(begin(game.sets), end(game.sets), isPossible));
-	});
+		if (!chunk.hasOnlyPuzzleColours())
+			return solveStreaming(input);
+
+		sums.partOne += chunk.sums.partOne;
+		sums.partTwo += chunk.sums.partTwo;
+	}
+
+	return sums;
 }
 
-static uint64_t partTwo(const std::vector<Game02>& games)
+// Below this, starting threads costs more than it saves.
+static constexpr size_t MinParallelInputSize = size_t(1) << 20;
+
+// Folding the lines as they're parsed edges out storing the games in columns for the SIMD kernels,
+// though only the columns can be indexed for bag queries.
+static const aoc::KernelSet<aoc::Answers<>(std::string_view)> solveKernels(2, "day02.solve",
+{
+	{ { .name = "parallel", .multithreaded = true, .minInputSize = MinParallelInputSize }, &solveStreamingInParallel },
+	{ { .name = "streaming" }, &solveStreaming },
+	{ { .name = "columnar" }, &solveColumnar },
+});
+
+aoc::Answers<> aoc::solveDay02(std::string_view input)
+{
+	return solveKernels.select(input.size())(input);
+}
+
+std::optional<aoc::Answers<>> aoc::solveDay02Piece(std::string_view piece)
+{
+	const GameLogSums pieceSums = sumGameLog(piece);
+	if (!pieceSums.hasOnlyPuzzleColours())
+		return {};
+
+	return pieceSums.sums;
+}
+
+class aoc::Day02Stream::Sums : public GameLogSums
+{
+};
+
+aoc::Day02Stream::Day02Stream()
+	: sums(std::make_unique<Sums>())
 {
-	return std::accumulate(begin(games), end(games), 0ull, [] (uint64_t sum, const Game02& game)
+}
+
+aoc::Day02Stream::~Day02Stream() = default;
+
+void aoc::Day02Stream::addLine(std::string_view line)
+{
+	sums->addLine(line);
+}
+
+aoc::Answers<> aoc::Day02Stream::getAnswers() const
+{
+	return sums->sums;
+}
+
+// A game is possible with any bag that dominates its min possible set, so the games are indexed
+// by those, weighted by ID, and each bag is then answered without rescanning the games.
+// Bags only hold the puzzle's colours, so games showing any others are never possible.
+template <size_t NumColours>
+static constexpr aoc::DominanceIndex<3> indexGames(const Games02<NumColours>& games, size_t maxCells)
+{
+	std::vector<aoc::DominanceIndex<3>::Point> minPossibleSets;
+	std::vector<uint64_t> ids;
+
+	for (size_t i = 0; i < games.size(); ++i)
 	{
-		return sum + game.getMinPossibleSet().getPower();
-	});
+		bool onlyPuzzleColours = true;
+		for (size_t colour = PuzzleColours.size(); colour < games.getNumColours(); ++colour)
+			onlyPuzzleColours = onlyPuzzleColours && games.colours[colour][i] == 0;
+
+		if (!onlyPuzzleColours)
+			continue;
+
+		minPossibleSets.push_back({ games.colours[Red][i], games.colours[Green][i], games.colours[Blue][i] });
+		ids.push_back(games.ids[i]);
+	}
+
+	return aoc::DominanceIndex<3>(minPossibleSets, ids, maxCells);
+}
+
+static constexpr std::vector<aoc::DominanceTotals> queryIndex(const aoc::DominanceIndex<3>& index, std::span<const std::array<uint64_t, 3>> bags)
+{
+	std::vector<aoc::DominanceTotals> results;
+	results.reserve(bags.size());
+
+	for (const std::array<uint64_t, 3>& bag : bags)
+		results.push_back(index.query(bag));
+
+	return results;
+}
+
+static constexpr std::vector<aoc::DominanceTotals> queryBags(std::string_view input, std::span<const std::array<uint64_t, 3>> bags,
+	size_t maxCells = aoc::DominanceIndex<3>::MaxCells)
+{
+	if (const std::optional<Games02<3>> games = loadGames<3>(input))
+		return queryIndex(indexGames(*games, maxCells), bags);
+
+	return queryIndex(indexGames(*loadGames<AnyColours>(input), maxCells), bags);
 }
 
-static auto process(const char* filename)
+std::vector<aoc::DominanceTotals> aoc::solveDay02Bags(std::string_view input, std::span<const std::array<uint64_t, 3>> bags)
 {
-	const std::vector<Game02> games = loadGames(filename);
-	return std::make_pair(partOne(games), partTwo(games));
+	return queryBags(input, bags);
 }
 
+// Copy of data/02/test.txt, checked at compile time.
+static constexpr std::string_view testInput =
+R"(Game 1: 3 blue, 4 red; 1 red, 2 green, 6 blue; 2 green
+Game 2: 1 blue, 2 green; 3 green, 4 blue, 1 red; 1 green, 1 blue
+Game 3: 8 green, 6 blue, 20 red; 5 blue, 4 red, 13 green; 5 green, 1 red
+Game 4: 1 green, 3 red, 6 blue; 3 green, 6 red; 3 green, 15 blue, 14 red
+Game 5: 6 red, 1 blue, 3 green; 2 blue, 1 red, 2 green)";
+
+static_assert(processScalar(testInput) == aoc::Answers<>{ 8, 2286 });
+static_assert(processAnyColours(testInput) == aoc::Answers<>{ 8, 2286 });
+static_assert(solveStreaming(testInput) == aoc::Answers<>{ 8, 2286 });
+
+static constexpr std::array<std::array<uint64_t, 3>, 4> testBags = {{ { 12, 13, 14 }, { 0, 0, 0 }, { 4, 3, 6 }, { 20, 13, 15 } }};
+static_assert(queryBags(testInput, testBags) == std::vector<aoc::DominanceTotals>{ { 3, 8 }, { 0, 0 }, { 2, 3 }, { 5, 15 } });
+
+// With no room for a table, the index falls back to its tree.
+static_assert(queryBags(testInput, testBags, 0) == std::vector<aoc::DominanceTotals>{ { 3, 8 }, { 0, 0 }, { 2, 3 }, { 5, 15 } });
+
+// Game 1 shows a fourth colour, so is impossible with the puzzle's bag, and game 2 never shows it, so has no power.
+static constexpr std::string_view testInputFourColours =
+R"(Game 1: 1 red, 2 green; 3 blue, 2 yellow
+Game 2: 1 red, 2 green, 3 blue)";
+
+static_assert(processScalar(testInputFourColours) == aoc::Answers<>{ 2, 12 });
+static_assert(solveStreaming(testInputFourColours) == aoc::Answers<>{ 2, 12 });
+static_assert(queryBags(testInputFourColours, testBags) == std::vector<aoc::DominanceTotals>{ { 1, 2 }, { 0, 0 }, { 1, 2 }, { 1, 2 } });
+static_assert(queryBags(testInputFourColours, testBags, 0) == std::vector<aoc::DominanceTotals>{ { 1, 2 }, { 0, 0 }, { 1, 2 }, { 1, 2 } });
+
 static void processPrintAndAssert(const char* filename, std::optional<std::pair<uint64_t, uint64_t>> expected = {})
 {
-	const auto result = process(filename);
-	std::cout << "Part 1: " << result.first << " Part 2: " << result.second << std::endl;
-	assert(!expected || result == expected);
+	const auto result = aoc::solveDay02(aoc::readFile(filename));
+	std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
+	assert(!expected || (result.partOne == expected.value().first && result.partTwo == expected.value().second));
 }
 
 void day02()
 {
 	processPrintAndAssert("../data/02/test.txt", std::make_pair(8ull, 2286ull));
 	processPrintAndAssert("../data/02/real.txt", std::make_pair(2447ull, 56322ull));
+
+	// The file's bound first, as range-for doesn't extend the lifetime of temporaries within its range before C++23.
+	const std::string real = aoc::readFile("../data/02/real.txt");
+
+	aoc::Day02Stream stream;
+	for (const std::string_view line : aoc::lines(real))
+		stream.addLine(line);
+
+	assert(stream.getAnswers() == aoc::Answers<>(2447, 56322));
+
+	// Streamed lines may share a buffer, so colours first seen in one line mustn't depend on it afterwards.
+	std::string buffer = "Game 1: 2 yellow, 1 red, 1 green, 1 blue";
+	aoc::Day02Stream reusedBufferStream;
+	reusedBufferStream.addLine(buffer);
+	buffer = "Game 2: 1 red, 2 green, 3 blue, 4 yellow";
+	reusedBufferStream.addLine(buffer);
+
+	assert(reusedBufferStream.getAnswers().partTwo == 26);
+
+	static constexpr std::array<std::array<uint64_t, 3>, 1> puzzleBag = {{ { 12, 13, 14 } }};
+	assert(aoc::solveDay02Bags(real, puzzleBag).front().weightSum == 2447);
 }
@@ -1,13 +1,18 @@
 #include <algorithm>
+#include <array>
 #include <cassert>
-#include <fstream>
 #include <iostream>
-#include <numeric>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "aoc.h"
+#include "dispatch.h"
+#include "input.h"
+#include "shard.h"
+
 struct Symbol
 {
 	char symbol = 0;
@@ -20,57 +25,78 @@ struct Part
 	uint64_t value = 0;
 	size_t x = 0;
 	size_t y = 0;
+	size_t numDigits = 0;
 
-	size_t width() const { return static_cast<size_t>(log10(value) + 1); }
-	size_t height() const { return 1; }
+	size_t width() const { return numDigits; }
 };
 
+// Indices into the schematic's parts and symbols.
 struct Gear
 {
-	const Part* part1 = nullptr;
-	const Part* part2 = nullptr;
-	const Symbol* symbol = nullptr;
-
-	uint64_t ratio() const { return part1->value * part2->value; }
+	uint32_t part1 = 0;
+	uint32_t part2 = 0;
+	uint32_t symbol = 0;
 };
 
 class Schematic
 {
 public:
-	std::vector<std::string> data;
+	// Marks cells not covered by any part in partLabels.
+	static constexpr uint32_t NoPart = UINT32_MAX;
+
+	std::vector<std::string_view> data;
 	size_t width = 0;
 	size_t height = 0;
 
+	// A band of a larger schematic has a halo row above and below it, from the neighbouring bands.
+	// They're only there for their symbols and parts to be found as neighbours. Parts and gears in
+	// them belong to the neighbouring bands, and aren't counted in this one's answers.
+	size_t firstOwnedRow = 0;
+	size_t endOwnedRow = 0;
+
 	std::vector<Part> parts;
 	std::vector<Symbol> symbols;
 	std::vector<Gear> gears;
 
-	std::vector<const Part*> partsNeighbouringSymbols;
-	std::unordered_map<const Symbol*, std::vector<const Part*>> symbolPartMap;
+	// Index into parts of the part covering each cell, row by row.
+	std::vector<uint32_t> partLabels;
 
-	explicit Schematic(const char* filename)
+	// Compressed sparse rows of the parts neighbouring each symbol: symbol i's parts are
+	// symbolParts[symbolPartOffsets[i]] up to symbolParts[symbolPartOffsets[i + 1]].
+	std::vector<uint32_t> symbolPartOffsets;
+	std::vector<uint32_t> symbolParts;
+
+	// Whether each part neighbours any symbol, however many.
+	std::vector<uint8_t> isPartNextToSymbol;
+
+	std::span<const uint32_t> getSymbolParts(size_t symbol) const
 	{
-		loadData(filename);
-		identifyPartsAndSynbols();
+		return std::span(symbolParts).subspan(symbolPartOffsets[symbol], symbolPartOffsets[symbol + 1] - symbolPartOffsets[symbol]);
+	}
+
+	bool ownsRow(size_t row) const { return firstOwnedRow <= row && row < endOwnedRow; }
+
+	explicit Schematic(std::string_view input, size_t haloRowsAbove = 0, size_t haloRowsBelow = 0)
+	{
+		loadData(input);
+
+		assert(haloRowsAbove + haloRowsBelow <= height);
+		firstOwnedRow = haloRowsAbove;
+		endOwnedRow = height - haloRowsBelow;
+
+		identifyPartsAndSymbols();
 		buildPartSymbolMap();
 		identifyGears();
 	}
 
 private:
-	void loadData(const char* filename)
+	void loadData(std::string_view input)
 	{
-		std::fstream s{ filename, s.in };
-		assert(s.is_open());
-
-		while (s.peek() != EOF)
+		for (const std::string_view line : aoc::lines(input))
 		{
-			std::string line;
-			std::getline(s, line);
-
 			assert(line.size() > 0);
-			assert(line.back() != '\n');
 
-			data.push_back(line);
+			data.emplace_back(line);
 
 			if (width != 0)
 				assert(line.size() == width);
@@ -80,19 +106,32 @@ private:
 
 		height = data.size();
 	}
-	
-	void identifyPartsAndSynbols()
+
+	// One pass over the cells, reading each part's digits as they're passed and labelling the cells it covers.
+	void identifyPartsAndSymbols()
 	{
+		partLabels.assign(width * height, NoPart);
+
 		for (size_t row = 0; row < height; ++row)
 		{
 			for (size_t col = 0; col < width; ++col)
 			{
 				const char c = data[row][col];
-				if (std::isdigit(c))
+				if (aoc::isDigit(c))
 				{
-					const uint64_t partNum = std::stoull(data[row].substr(col));
-					parts.push_back({ partNum, col, row });
-					col += parts.back().width() - 1;
+					Part part = { 0, col, row, 0 };
+
+					for (; col < width && aoc::isDigit(data[row][col]); ++col)
+					{
+						part.value = (part.value * 10) + (data[row][col] - '0');
+						part.numDigits += 1;
+						partLabels[(row * width) + col] = (uint32_t) parts.size();
+					}
+
+					parts.push_back(part);
+
+					// The loop's increment would otherwise skip the cell after the part, which may be a symbol.
+					--col;
 				}
 				else if (c != '.')
 				{
@@ -102,80 +141,549 @@ private:
 		}
 	}
 
+	// Calls visit with the index of each part neighbouring the symbol, from the labels of its eight
+	// neighbours. A part covering several of them is only visited once, and it's only ever next to the
+	// same part's cells in the same row.
+	template <typename Visit>
+	void forEachNeighbouringPart(const Symbol& symbol, const Visit& visit) const
+	{
+		const size_t minX = symbol.x == 0 ? symbol.x : symbol.x - 1;
+		const size_t maxX = std::min(symbol.x + 1, width - 1);
+		const size_t minY = symbol.y == 0 ? symbol.y : symbol.y - 1;
+		const size_t maxY = std::min(symbol.y + 1, height - 1);
+
+		for (size_t y = minY; y <= maxY; ++y)
+		{
+			uint32_t previousLabel = NoPart;
+
+			for (size_t x = minX; x <= maxX; ++x)
+			{
+				const uint32_t label = partLabels[(y * width) + x];
+
+				if (label != NoPart && label != previousLabel)
+					visit(label);
+
+				previousLabel = label;
+			}
+		}
+	}
+
+	// Two passes over the symbols, the first counting each one's parts to size its row, the second filling them in.
 	void buildPartSymbolMap()
 	{
-		std::vector<std::vector<const Symbol*>> symbolsPerRow;
-		symbolsPerRow.resize(height);
+		symbolPartOffsets.assign(symbols.size() + 1, 0);
+
+		for (size_t i = 0; i < symbols.size(); ++i)
+		{
+			uint32_t count = 0;
+			forEachNeighbouringPart(symbols[i], [&count] (uint32_t) { ++count; });
+			symbolPartOffsets[i + 1] = symbolPartOffsets[i] + count;
+		}
+
+		symbolParts.resize(symbolPartOffsets.back());
+		isPartNextToSymbol.assign(parts.size(), 0);
+
+		for (size_t i = 0; i < symbols.size(); ++i)
+		{
+			uint32_t next = symbolPartOffsets[i];
+
+			forEachNeighbouringPart(symbols[i], [&] (uint32_t part)
+			{
+				symbolParts[next++] = part;
+				isPartNextToSymbol[part] = 1;
+			});
+		}
+	}
+
+	void identifyGears()
+	{
+		for (size_t i = 0; i < symbols.size(); ++i)
+		{
+			const std::span<const uint32_t> neighbours = getSymbolParts(i);
+
+			if (symbols[i].symbol == '*' && neighbours.size() == 2 && ownsRow(symbols[i].y))
+				gears.push_back({ neighbours[0], neighbours[1], (uint32_t) i });
+		}
+	}
+};
+
+// Parts next to several symbols are only counted once.
+static uint64_t partOne(const Schematic& schematic)
+{
+	uint64_t sum = 0;
+
+	for (size_t i = 0; i < schematic.parts.size(); ++i)
+		sum += schematic.parts[i].value * (schematic.isPartNextToSymbol[i] && schematic.ownsRow(schematic.parts[i].y));
+
+	return sum;
+}
+
+static uint64_t partTwo(const Schematic& schematic)
+{
+	uint64_t sum = 0;
+
+	for (const Gear& gear : schematic.gears)
+		sum += schematic.parts[gear.part1].value * schematic.parts[gear.part2].value;
+
+	return sum;
+}
+
+static aoc::Answers<> solveSchematic(std::string_view input, size_t haloRowsAbove = 0, size_t haloRowsBelow = 0)
+{
+	const Schematic schematic(input, haloRowsAbove, haloRowsBelow);
+	return { partOne(schematic), partTwo(schematic) };
+}
+
+static aoc::Answers<> solveWhole(std::string_view input)
+{
+	return solveSchematic(input);
+}
+
+// Parts lie within a row, so splitting the schematic into bands of whole rows never splits a part.
+// Each band is solved on its own thread along with the row either side of it, and owns the parts
+// and gears in its own rows, so the bands' answers add up to the whole schematic's.
+static aoc::Answers<> solveInBands(std::string_view input, size_t numBands)
+{
+	const std::vector<aoc::Answers<>> bandAnswers = aoc::solveChunksInParallel(input, [input] (std::string_view band)
+	{
+		size_t begin = (size_t) (band.data() - input.data());
+		size_t end = begin + band.size();
+
+		// Chunks end just after a line break, or at the end of the input.
+		const size_t haloRowsAbove = (begin > 0) ? 1 : 0;
+		if (haloRowsAbove > 0)
+			begin = input.rfind('\n', begin - 2) + 1; // npos + 1 is 0, for the first row
+
+		const size_t haloRowsBelow = (end < input.size()) ? 1 : 0;
+		if (haloRowsBelow > 0)
+			end = std::min(input.find('\n', end), input.size());
+
+		return solveSchematic(input.substr(begin, end - begin), haloRowsAbove, haloRowsBelow);
+	}, numBands);
+
+	aoc::Answers<> answers;
+
+	for (const aoc::Answers<>& band : bandAnswers)
+	{
+		answers.partOne += band.partOne;
+		answers.partTwo += band.partTwo;
+	}
+
+	return answers;
+}
+
+static aoc::Answers<> solveInBandPerThread(std::string_view input)
+{
+	return solveInBands(input, aoc::cpuFeatures().hardwareThreads);
+}
+
+// One row of a schematic being streamed, with its parts and which of them covers each of its cells.
+// The cells are copied, as the line they're read from needn't outlive the call passing it in.
+struct SchematicRow
+{
+	std::string cells;
+	std::vector<Part> parts;
+	std::vector<uint32_t> partLabels; // index into parts, or Schematic::NoPart
+
+	constexpr void load(std::string_view line, size_t y)
+	{
+		cells.assign(line);
+		parts.clear();
+		partLabels.assign(line.size(), Schematic::NoPart);
+
+		for (size_t col = 0; col < cells.size(); ++col)
+		{
+			if (!aoc::isDigit(cells[col]))
+				continue;
+
+			Part part = { 0, col, y, 0 };
+
+			for (; col < cells.size() && aoc::isDigit(cells[col]); ++col)
+			{
+				part.value = (part.value * 10) + (uint64_t) (cells[col] - '0');
+				part.numDigits += 1;
+				partLabels[col] = (uint32_t) parts.size();
+			}
+
+			parts.push_back(part);
+		}
+	}
+
+	constexpr bool hasSymbolIn(size_t minX, size_t maxX) const
+	{
+		for (size_t x = minX; x <= maxX; ++x)
+			if (cells[x] != '.' && !aoc::isDigit(cells[x]))
+				return true;
+
+		return false;
+	}
+};
+
+// Solves a schematic a row at a time, keeping only the three rows that adjacency reaches, so that its
+// memory grows with the schematic's width but not its height.
+//
+// A row's parts and gears are settled once the row below it has arrived, so each row is evaluated as
+// the middle of the window when the next one is added, and the last row when the answers are taken.
+// Rows evaluated are folded into the sums, which are all that's carried forward.
+class SchematicStream
+{
+public:
+	constexpr void addLine(std::string_view line)
+	{
+		assert(line.size() > 0);
+		assert(numRows == 0 || line.size() == window[2].cells.size());
+
+		// The oldest row's storage is reused for the newest.
+		std::rotate(begin(window), begin(window) + 1, end(window));
+		window[2].load(line, numRows);
+		++numRows;
+
+		if (numRows >= 2)
+		{
+			const aoc::Answers<> row = evaluateRow(numRows >= 3 ? &window[0] : nullptr, window[1], &window[2]);
+			sums.partOne += row.partOne;
+			sums.partTwo += row.partTwo;
+		}
+	}
+
+	constexpr aoc::Answers<> getAnswers() const
+	{
+		if (numRows == 0)
+			return sums;
+
+		const aoc::Answers<> lastRow = evaluateRow(numRows >= 2 ? &window[1] : nullptr, window[2], nullptr);
+		return { sums.partOne + lastRow.partOne, sums.partTwo + lastRow.partTwo };
+	}
+
+private:
+	// The answers from the parts and gears in a row, given the rows either side of it, where there are any.
+	// As in Schematic, parts next to several symbols are only counted once.
+	static constexpr aoc::Answers<> evaluateRow(const SchematicRow* above, const SchematicRow& row, const SchematicRow* below)
+	{
+		const std::array<const SchematicRow*, 3> neighbourhood = { above, &row, below };
+		const size_t width = row.cells.size();
 
-		for (const Symbol& s : symbols)
-			symbolsPerRow[s.y].push_back(&s);
+		aoc::Answers<> answers;
 
-		for (const Part& part : parts)
+		for (const Part& part : row.parts)
 		{
 			const size_t minX = part.x == 0 ? part.x : part.x - 1;
-			const size_t maxX = std::min(part.x + part.width(), width - 1);
-			const size_t minY = part.y == 0 ? part.y : part.y - 1;
-			const size_t maxY = std::min(part.y + part.height(), height - 1);
+			const size_t maxX = std::min(part.x + part.numDigits, width - 1);
+
+			bool isNextToSymbol = false;
+			for (const SchematicRow* neighbour : neighbourhood)
+				isNextToSymbol = isNextToSymbol || (neighbour && neighbour->hasSymbolIn(minX, maxX));
+
+			answers.partOne += part.value * isNextToSymbol;
+		}
 
-			for (size_t y = minY; y <= maxY; ++y)
+		for (size_t x = row.cells.find('*'); x != std::string::npos; x = row.cells.find('*', x + 1))
+		{
+			const size_t minX = x == 0 ? x : x - 1;
+			const size_t maxX = std::min(x + 1, width - 1);
+
+			uint32_t numParts = 0;
+			uint64_t ratio = 1;
+
+			for (const SchematicRow* neighbour : neighbourhood)
 			{
-				for (const Symbol* symbol : symbolsPerRow[y])
+				if (!neighbour)
+					continue;
+
+				uint32_t previousLabel = Schematic::NoPart;
+
+				for (size_t nx = minX; nx <= maxX; ++nx)
 				{
-					if (minX <= symbol->x && symbol->x <= maxX)
+					const uint32_t label = neighbour->partLabels[nx];
+
+					if (label != Schematic::NoPart && label != previousLabel)
 					{
-						partsNeighbouringSymbols.push_back(&part);
-						symbolPartMap[symbol].push_back(&part);
+						numParts += 1;
+						ratio *= neighbour->parts[label].value;
 					}
+
+					previousLabel = label;
 				}
 			}
+
+			if (numParts == 2)
+				answers.partTwo += ratio;
 		}
+
+		return answers;
 	}
 
-	void identifyGears()
+	std::array<SchematicRow, 3> window; // oldest first
+	size_t numRows = 0;
+	aoc::Answers<> sums;
+};
+
+static constexpr aoc::Answers<> solveStreaming(std::string_view input)
+{
+	SchematicStream stream;
+
+	for (const std::string_view line : aoc::lines(input))
+		stream.addLine(line);
+
+	return stream.getAnswers();
+}
+
+// A schematic's part/symbol adjacency reduced to the totals that queries need, so that each costs a
+// lookup rather than another pass over the schematic.
+//
+// Symbols are grouped into classes by character. Class 0 stands for every symbol, so that queries
+// for aoc::Day03Index::AnySymbol need no special handling.
+class SchematicIndex
+{
+public:
+	// Each of the three rows around a symbol can hold at most two separate parts next to it.
+	static constexpr size_t MaxNeighbouringParts = 6;
+
+	explicit SchematicIndex(const Schematic& schematic)
 	{
-		for (auto pair : symbolPartMap)
-			if (pair.first->symbol == '*' && pair.second.size() == 2)
-				gears.push_back({ pair.second[0], pair.second[1], pair.first });
+		identifyClasses(schematic);
+		sumPartsByClass(schematic);
+		sumProductsAndRankSymbols(schematic);
 	}
+
+	std::string_view getSymbolClasses() const { return symbolClasses; }
+
+	uint64_t sumPartsNextTo(char symbol) const
+	{
+		const uint8_t symbolClass = classOf[(uint8_t) symbol];
+		return symbolClass != NoClass ? partSums[symbolClass] : 0;
+	}
+
+	uint64_t sumPartProducts(char symbol, size_t numParts) const
+	{
+		const uint8_t symbolClass = classOf[(uint8_t) symbol];
+		return (symbolClass != NoClass && numParts <= MaxNeighbouringParts) ? productSums[symbolClass][numParts] : 0;
+	}
+
+	std::vector<aoc::SymbolTotal> getTopSymbols(size_t count) const
+	{
+		return std::vector<aoc::SymbolTotal>(begin(rankedSymbols), begin(rankedSymbols) + (ptrdiff_t) std::min(count, rankedSymbols.size()));
+	}
+
+private:
+	static constexpr uint8_t NoClass = UINT8_MAX;
+
+	void identifyClasses(const Schematic& schematic)
+	{
+		std::array<bool, 256> isPresent = {};
+
+		for (const Symbol& symbol : schematic.symbols)
+			isPresent[(uint8_t) symbol.symbol] = true;
+
+		classOf.fill(NoClass);
+		classOf[(uint8_t) aoc::Day03Index::AnySymbol] = 0;
+
+		for (size_t c = 1; c < isPresent.size(); ++c)
+		{
+			if (!isPresent[c])
+				continue;
+
+			symbolClasses.push_back((char) c);
+			classOf[c] = (uint8_t) symbolClasses.size();
+		}
+
+		partSums.assign(symbolClasses.size() + 1, 0);
+		productSums.assign(symbolClasses.size() + 1, {});
+	}
+
+	// A part next to several symbols of a class only counts once for it. Visiting the symbols a class
+	// at a time, each part only needs to remember the last class it was counted for.
+	void sumPartsByClass(const Schematic& schematic)
+	{
+		for (size_t i = 0; i < schematic.parts.size(); ++i)
+			partSums[0] += schematic.parts[i].value * schematic.isPartNextToSymbol[i];
+
+		std::vector<uint32_t> symbolsByClass(schematic.symbols.size());
+		for (size_t i = 0; i < symbolsByClass.size(); ++i)
+			symbolsByClass[i] = (uint32_t) i;
+
+		std::stable_sort(begin(symbolsByClass), end(symbolsByClass), [&] (uint32_t a, uint32_t b)
+		{
+			return classOf[(uint8_t) schematic.symbols[a].symbol] < classOf[(uint8_t) schematic.symbols[b].symbol];
+		});
+
+		std::vector<uint8_t> lastCountedClass(schematic.parts.size(), NoClass);
+
+		for (const uint32_t symbol : symbolsByClass)
+		{
+			const uint8_t symbolClass = classOf[(uint8_t) schematic.symbols[symbol].symbol];
+
+			for (const uint32_t part : schematic.getSymbolParts(symbol))
+			{
+				if (lastCountedClass[part] == symbolClass)
+					continue;
+
+				lastCountedClass[part] = symbolClass;
+				partSums[symbolClass] += schematic.parts[part].value;
+			}
+		}
+	}
+
+	void sumProductsAndRankSymbols(const Schematic& schematic)
+	{
+		rankedSymbols.reserve(schematic.symbols.size());
+
+		for (size_t i = 0; i < schematic.symbols.size(); ++i)
+		{
+			const Symbol& symbol = schematic.symbols[i];
+			const std::span<const uint32_t> neighbours = schematic.getSymbolParts(i);
+			assert(neighbours.size() <= MaxNeighbouringParts);
+
+			uint64_t product = 1;
+			uint64_t sum = 0;
+
+			for (const uint32_t part : neighbours)
+			{
+				product *= schematic.parts[part].value;
+				sum += schematic.parts[part].value;
+			}
+
+			productSums[0][neighbours.size()] += product;
+			productSums[classOf[(uint8_t) symbol.symbol]][neighbours.size()] += product;
+
+			rankedSymbols.push_back({ symbol.symbol, symbol.x, symbol.y, sum });
+		}
+
+		// The symbols were found in reading order, which a stable sort keeps for ties.
+		std::stable_sort(begin(rankedSymbols), end(rankedSymbols), [] (const aoc::SymbolTotal& a, const aoc::SymbolTotal& b)
+		{
+			return a.partSum > b.partSum;
+		});
+	}
+
+	std::array<uint8_t, 256> classOf = {};
+	std::string symbolClasses; // class i + 1, ascending
+
+	std::vector<uint64_t> partSums; // [class]
+	std::vector<std::array<uint64_t, MaxNeighbouringParts + 1>> productSums; // [class][number of parts]
+	std::vector<aoc::SymbolTotal> rankedSymbols;
 };
 
-static uint64_t partOne(const Schematic& schematic)
+// Below this, starting threads costs more than it saves.
+static constexpr size_t MinParallelInputSize = size_t(1) << 20;
+
+// Streaming three rows at a time stays in cache, where building the whole schematic's label grid doesn't.
+static const aoc::KernelSet<aoc::Answers<>(std::string_view)> solveKernels(3, "day03.solve",
 {
-	return std::accumulate(
-		begin(schematic.partsNeighbouringSymbols),
-		end(schematic.partsNeighbouringSymbols),
-		0ull,
-		[] (uint64_t sum, const Part* part) { return sum + part->value; }
-	);
+	{ { .name = "bands", .multithreaded = true, .minInputSize = MinParallelInputSize }, &solveInBandPerThread },
+	{ { .name = "streaming" }, &solveStreaming },
+	{ { .name = "whole" }, &solveWhole },
+});
+
+aoc::Answers<> aoc::solveDay03(std::string_view input)
+{
+	return solveKernels.select(input.size())(input);
 }
 
-static uint64_t partTwo(const Schematic& schematic)
+class aoc::Day03Stream::Window : public SchematicStream
+{
+};
+
+aoc::Day03Stream::Day03Stream()
+	: window(std::make_unique<Window>())
+{
+}
+
+aoc::Day03Stream::~Day03Stream() = default;
+
+void aoc::Day03Stream::addLine(std::string_view line)
 {
-	return std::accumulate(
-		begin(schematic.gears),
-		end(schematic.gears),
-		0ull,
-		[] (uint64_t sum, const Gear& gear) { return sum + gear.ratio(); }
-	);
+	window->addLine(line);
 }
 
-static std::pair<uint64_t, uint64_t> process(const char* filename)
+aoc::Answers<> aoc::Day03Stream::getAnswers() const
 {
-	const Schematic schematic(filename);
-	return std::make_pair(partOne(schematic), partTwo(schematic));
+	return window->getAnswers();
 }
 
+class aoc::Day03Index::Index : public SchematicIndex
+{
+public:
+	using SchematicIndex::SchematicIndex;
+};
+
+aoc::Day03Index::Day03Index(std::string_view input)
+	: index(std::make_unique<Index>(Schematic(input)))
+{
+}
+
+aoc::Day03Index::~Day03Index() = default;
+
+std::string_view aoc::Day03Index::getSymbolClasses() const
+{
+	return index->getSymbolClasses();
+}
+
+uint64_t aoc::Day03Index::sumPartsNextTo(char symbol) const
+{
+	return index->sumPartsNextTo(symbol);
+}
+
+uint64_t aoc::Day03Index::sumPartProducts(char symbol, size_t numParts) const
+{
+	return index->sumPartProducts(symbol, numParts);
+}
+
+std::vector<aoc::SymbolTotal> aoc::Day03Index::getTopSymbols(size_t count) const
+{
+	return index->getTopSymbols(count);
+}
+
+static constexpr std::string_view testInput =
+R"(467..114..
+...*......
+..35..633.
+......#...
+617*......
+.....+.58.
+..592.....
+......755.
+...$.*....
+.664.598..)";
+
+static_assert(solveStreaming(testInput) == aoc::Answers<>{ 4361, 467835 });
+
 static void processPrintAndAssert(const char* filename, std::optional<std::pair<uint64_t, uint64_t>> expected = {})
 {
-	const auto result = process(filename);
-	std::cout << "Part 1: " << result.first << " Part 2: " << result.second << std::endl;
+	const auto result = aoc::solveDay03(aoc::readFile(filename));
+	std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
 
-	assert(!expected || expected.value().first == 0 || result.first == expected.value().first);
-	assert(!expected || expected.value().second == 0 || result.second == expected.value().second);
+	assert(!expected || expected.value().first == 0 || result.partOne == expected.value().first);
+	assert(!expected || expected.value().second == 0 || result.partTwo == expected.value().second);
+}
+
+// The index answers the puzzle's own questions as special cases.
+static void queryAndAssert()
+{
+	const aoc::Day03Index index(testInput);
+
+	assert(index.getSymbolClasses() == "#$*+");
+	assert(index.sumPartsNextTo(aoc::Day03Index::AnySymbol) == 4361);
+	assert(index.sumPartProducts('*', 2) == 467835);
+	assert(index.sumPartsNextTo('*') == 467 + 35 + 617 + 755 + 598);
+	assert(index.sumPartProducts('*', 1) == 617);
+	assert(index.sumPartProducts(aoc::Day03Index::AnySymbol, 1) == 633 + 617 + 592 + 664);
+	assert(index.getTopSymbols(2) == (std::vector<aoc::SymbolTotal>{ { '*', 5, 8, 755 + 598 }, { '$', 3, 8, 664 } }));
 }
 
 void day03()
 {
+	queryAndAssert();
 	processPrintAndAssert("../data/03/test.txt", std::make_pair(4361ull, 467835ull));
 	processPrintAndAssert("../data/03/real.txt", std::make_pair(539713ull, 84159075ull));
+
+	// Bands are only solved for large inputs on machines with several threads, so they're checked
+	// here directly, with bands of a few rows each, along with the other variants.
+	const std::string real = aoc::readFile("../data/03/real.txt");
+
+	for (const size_t numBands : { 2u, 3u, 7u, 64u })
+		assert(solveInBands(real, numBands) == aoc::Answers<>(539713, 84159075));
+
+	assert(solveStreaming(real) == aoc::Answers<>(539713, 84159075));
+	assert(solveWhole(real) == aoc::Answers<>(539713, 84159075));
 }
@@ -1,6 +1,5 @@
 #include <algorithm>
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <numeric>
 #include <optional>
@@ -9,6 +8,9 @@
 #include <string>
 #include <vector>
 
+#include "aoc.h"
+#include "input.h"
+
 struct Game04
 {
 	uint64_t id = 0;
@@ -46,7 +48,7 @@ struct Game04
 	}
 };
 
-static Game04 parseGame(const std::string& gameString)
+static Game04 parseGame(std::string_view gameString)
 {
 	Game04 game;
 
@@ -89,17 +91,12 @@ static void evaluateCopies(auto& games)
 	}
 }
 
-static auto loadData(const char* filename)
+static auto loadData(std::string_view input)
 {
-	std::fstream s{ filename, s.in };
-	assert(s.is_open());
-
 	std::vector<Game04> games;
 
-	while (s.peek() != EOF)
+	for (const std::string_view line : aoc::lines(input))
 	{
-		std::string line;
-		std::getline(s, line);
 		assert(line.size() > 0);
 		games.push_back(parseGame(line));
 	}
@@ -129,19 +126,19 @@ static uint64_t partTwo(const auto& data)
 	);
 }
 
-static std::pair<uint64_t, uint64_t> process(const char* filename)
+aoc::Answers<> aoc::solveDay04(std::string_view input)
 {
-	const auto data = loadData(filename);
-	return std::make_pair(partOne(data), partTwo(data));
+	const auto data = loadData(input);
+	return { partOne(data), partTwo(data) };
 }
 
 static void processPrintAndAssert(const char* filename, std::optional<std::pair<uint64_t, uint64_t>> expected = {})
 {
-	const auto result = process(filename);
-	std::cout << "Part 1: " << result.first << " Part 2: " << result.second << std::endl;
+	const auto result = aoc::solveDay04(aoc::readFile(filename));
+	std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
 
-	assert(!expected || expected.value().first == 0 || result.first == expected.value().first);
-	assert(!expected || expected.value().second == 0 || result.second == expected.value().second);
+	assert(!expected || expected.value().first == 0 || result.partOne == expected.value().first);
+	assert(!expected || expected.value().second == 0 || result.partTwo == expected.value().second);
 }
 
 void day04()
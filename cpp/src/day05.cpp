@@ -1,6 +1,5 @@
 #include <algorithm>
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <numeric>
 #include <optional>
@@ -9,6 +8,9 @@
 #include <vector>
 #include <unordered_map>
 
+#include "aoc.h"
+#include "input.h"
+
 struct Data05
 {
 	struct RemapRangeResult
@@ -121,18 +123,12 @@ struct Data05
 	}
 };
 
-static auto loadData(const char* filename)
+static auto loadData(std::string_view input)
 {
-	std::fstream s{ filename, s.in };
-	assert(s.is_open());
-
 	Data05 data;
 
-	while (s.peek() != EOF)
+	for (const std::string_view line : aoc::lines(input))
 	{
-		std::string line;
-		std::getline(s, line);
-
 		if (data.seeds.size() == 0)
 		{
 			size_t index = 0;
@@ -206,19 +202,19 @@ static uint64_t partTwo(const auto& data)
 	);
 }
 
-static std::pair<uint64_t, uint64_t> process(const char* filename)
+aoc::Answers<> aoc::solveDay05(std::string_view input)
 {
-	const auto data = loadData(filename);
-	return std::make_pair(partOne(data), partTwo(data));
+	const auto data = loadData(input);
+	return { partOne(data), partTwo(data) };
 }
 
 static void processPrintAndAssert(const char* filename, std::optional<std::pair<uint64_t, uint64_t>> expected = {})
 {
-	const auto result = process(filename);
-	std::cout << "Part 1: " << result.first << " Part 2: " << result.second << std::endl;
+	const auto result = aoc::solveDay05(aoc::readFile(filename));
+	std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
 
-	assert(!expected || expected.value().first == 0 || result.first == expected.value().first);
-	assert(!expected || expected.value().second == 0 || result.second == expected.value().second);
+	assert(!expected || expected.value().first == 0 || result.partOne == expected.value().first);
+	assert(!expected || expected.value().second == 0 || result.partTwo == expected.value().second);
 }
 
 void day05()
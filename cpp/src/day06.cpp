@@ -1,6 +1,5 @@
 #include <algorithm>
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <numeric>
 #include <optional>
@@ -9,117 +8,114 @@
 #include <vector>
 #include <unordered_map>
 
+#include "aoc.h"
+#include "input.h"
+
 struct Race
 {
 	uint64_t duration = 0;
 	uint64_t recordDistance = 0;
 
-	uint64_t calculateNumWaysOfWinning() const
+	constexpr uint64_t distanceWhenHeldFor(uint64_t holdTime) const
 	{
-		uint64_t winCount = 0;
+		const uint64_t speed = holdTime;
+		const uint64_t timeRemaining = duration - holdTime;
+		return speed * timeRemaining;
+	}
 
-		for (uint64_t i = 0; i < duration; ++i)
-		{
-			const uint64_t speed = i;
-			const uint64_t timeRemaining = duration - i;
-			const uint64_t distance = speed * timeRemaining;
+	constexpr uint64_t calculateNumWaysOfWinning() const
+	{
+		// The distance is symmetric about half the duration, where it is at its largest.
+		const uint64_t halfDuration = duration / 2;
+		if (distanceWhenHeldFor(halfDuration) <= recordDistance)
+			return 0;
 
-			winCount += distance > recordDistance;
+		// Solve holdTime * (duration - holdTime) = recordDistance for the shortest winning hold time,
+		// then nudge it to correct for the integer square root rounding.
+		const uint64_t discriminant = duration * duration - 4 * recordDistance;
+		uint64_t shortestHold = (duration - squareRoot(discriminant)) / 2;
+
+		while (distanceWhenHeldFor(shortestHold) <= recordDistance)
+			++shortestHold;
+
+		while (shortestHold > 0 && distanceWhenHeldFor(shortestHold - 1) > recordDistance)
+			--shortestHold;
+
+		const uint64_t longestHold = duration - shortestHold;
+		return longestHold - shortestHold + 1;
+	}
+
+	static constexpr uint64_t squareRoot(uint64_t value)
+	{
+		// Newton's method, rounded down.
+		if (value < 2)
+			return value;
+
+		uint64_t root = value;
+		uint64_t next = (root + 1) / 2;
+
+		while (next < root)
+		{
+			root = next;
+			next = (root + value / root) / 2;
 		}
 
-		return winCount;
+		return root;
 	}
 };
 
-static auto loadDataPartOne(const char* filename)
+static constexpr std::vector<Race> loadDataPartOne(std::string_view input)
 {
-	std::fstream s{ filename, s.in };
-	assert(s.is_open());
-
 	std::vector<Race> races;
+	bool parseDurations = true;
 
-	while (s.peek() != EOF)
+	for (std::string_view line : aoc::lines(input))
 	{
-		std::string line;
-		std::getline(s, line);
 		assert(line.size() > 0);
 
-		const bool parseDurations = races.size() == 0;
-		int index = 0;
+		size_t index = 0;
 
-		for (const auto word : std::views::split(line, ' '))
+		while (aoc::skipToNumber(line))
 		{
-			const std::string token(&*word.begin(), std::ranges::distance(word));
-
-			if (token.size() == 0)
-				continue;
-
-			if (!std::isdigit(token.front()))
-				continue;
+			const uint64_t number = (uint64_t) aoc::consumeNumber(line);
 
 			if (parseDurations)
-			{
-				races.push_back({});
-				races.back().duration = std::stoull(token);
-			}
+				races.push_back({ number, 0 });
 			else
-			{
-				races[index].recordDistance = std::stoull(token);
-				++index;
-			}
+				races[index++].recordDistance = number;
 		}
+
+		parseDurations = false;
 	}
 
 	return races;
 }
 
-static auto loadDataPartTwo(const char* filename)
+static constexpr Race loadDataPartTwo(std::string_view input)
 {
-	std::fstream s{ filename, s.in };
-	assert(s.is_open());
-
 	Race race;
+	bool parseDurations = true;
 
-	while (s.peek() != EOF)
+	for (const std::string_view line : aoc::lines(input))
 	{
-		std::string line;
-		std::getline(s, line);
 		assert(line.size() > 0);
 
-		const bool parseDurations = race.duration == 0;
-
-		for (const auto word : std::views::split(line, ' '))
-		{
-			const std::string token(&*word.begin(), std::ranges::distance(word));
-
-			if (token.size() == 0)
-				continue;
+		// The spaces between numbers are ignored, so all digits on a line make up a single number.
+		uint64_t& number = parseDurations ? race.duration : race.recordDistance;
 
-			if (!std::isdigit(token.front()))
-				continue;
+		for (const char c : line)
+			if (aoc::isDigit(c))
+				number = (number * 10) + (c - '0');
 
-			const uint64_t number = std::stoull(token);
-			const uint64_t numDigits = (uint64_t) log10(number) + 1;
-
-			if (parseDurations)
-			{
-				race.duration *= (uint64_t) pow(10, numDigits);
-				race.duration += number;
-			}
-			else
-			{
-				race.recordDistance *= (uint64_t) pow(10, numDigits);
-				race.recordDistance += number;
-			}
-		}
+		parseDurations = false;
 	}
 
 	return race;
 }
 
-static uint64_t partOne(const char* filename)
+static constexpr uint64_t partOne(std::string_view input)
 {
-	const auto races = loadDataPartOne(filename);
+	const auto races = loadDataPartOne(input);
 
 	return std::accumulate(
 		begin(races),
@@ -129,28 +125,39 @@ static uint64_t partOne(const char* filename)
 	);
 }
 
-static uint64_t partTwo(const char* filename)
+static constexpr uint64_t partTwo(std::string_view input)
 {
-	const auto race = loadDataPartTwo(filename);
+	const auto race = loadDataPartTwo(input);
 	return race.calculateNumWaysOfWinning();
 }
 
-static std::pair<uint64_t, uint64_t> process(const char* filename)
+static constexpr aoc::Answers<> process(std::string_view input)
 {
-	return std::make_pair(partOne(filename), partTwo(filename));
+	return { partOne(input), partTwo(input) };
 }
 
+aoc::Answers<> aoc::solveDay06(std::string_view input)
+{
+	return process(input);
+}
+
+// Copy of data/06/test.txt, checked at compile time.
+static constexpr std::string_view testInput =
+R"(Time:      7  15   30
+Distance:  9  40  200)";
+
+static_assert(process(testInput) == aoc::Answers<>{ 288, 71503 });
+
 static void processPrintAndAssert(const char* filename, std::optional<std::pair<uint64_t, uint64_t>> expected = {})
 {
-	const auto result = process(filename);
-	std::cout << "Part 1: " << result.first << " Part 2: " << result.second << std::endl;
+	const auto result = aoc::solveDay06(aoc::readFile(filename));
+	std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
 
-	assert(!expected || expected.value().first == 0 || result.first == expected.value().first);
-	assert(!expected || expected.value().second == 0 || result.second == expected.value().second);
+	assert(!expected || expected.value().first == 0 || result.partOne == expected.value().first);
+	assert(!expected || expected.value().second == 0 || result.partTwo == expected.value().second);
 }
 
 void day06()
 {
-	processPrintAndAssert("../data/06/test.txt", std::make_pair(288ull, 71503ull));
 	processPrintAndAssert("../data/06/real.txt", std::make_pair(608902ull, 46173809ull));
 }
@@ -1,6 +1,6 @@
 #include <algorithm>
+#include <array>
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <numeric>
 #include <optional>
@@ -9,6 +9,10 @@
 #include <vector>
 #include <unordered_map>
 
+#include "aoc.h"
+#include "diagnostics.h"
+#include "input.h"
+
 struct Game07
 {
 	enum class Hand
@@ -23,25 +27,28 @@ struct Game07
 		FiveOfAKind
 	};
 
+	// Cards are ranked by their index into an ordering of 15 possible card characters.
+	static constexpr size_t NumCardValues = 15;
+
 	std::string cardsAsString;
 	uint32_t bid = 0;
 
 	std::vector<int> cards;
-	std::unordered_map<int, int> cardCounts;
+	std::array<int, NumCardValues> cardCounts = {};
 	Hand hand = Hand::None;
 
-	explicit Game07(const std::string& _cards, uint32_t _bid)
+	constexpr explicit Game07(std::string_view _cards, uint32_t _bid)
 		: cardsAsString(_cards)
 		, bid(_bid)
 	{
 	}
 
-	void reset()
+	constexpr void reset()
 	{
 		*this = Game07(cardsAsString, bid);
 	}
 
-	void evaluatePart1()
+	constexpr void evaluatePart1()
 	{
 		reset();
 		convertStringToCardsWithValues("0123456789TJQKA");
@@ -49,7 +56,7 @@ struct Game07
 		evaluateHand();
 	}
 
-	void evaluatePart2()
+	constexpr void evaluatePart2()
 	{
 		reset();
 		convertStringToCardsWithValues("J123456789T_QKA");
@@ -60,35 +67,29 @@ struct Game07
 			bumpHandValue();
 	}
 
-	void convertStringToCardsWithValues(const std::string& ordering)
+	constexpr void convertStringToCardsWithValues(std::string_view ordering)
 	{
+		assert(ordering.size() == NumCardValues);
+
 		for (const char c : cardsAsString)
 			cards.push_back((int) ordering.find(c));
 
 		assert(std::find(begin(cards), end(cards), -1) == end(cards));
 	}
 
-	void countCards()
+	constexpr void countCards()
 	{
 		for (int card : cards)
 			cardCounts[card]++;
 	}
 
-	void evaluateHand()
+	constexpr void evaluateHand()
 	{
-		const int highestCardCount = std::accumulate(
-			begin(cardCounts),
-			end(cardCounts),
-			0,
-			[] (int count, auto iter) { return std::max(count, iter.first != 0 ? iter.second : 0); }
-		);
-
-		const int pairCount = std::accumulate(
-			begin(cardCounts),
-			end(cardCounts),
-			0,
-			[] (int sum, auto iter) { return sum + (iter.first != 0 && iter.second == 2); }
-		);
+		// Card value 0 is never counted towards the hand; in part two it is the joker.
+		const auto countedCards = std::views::drop(cardCounts, 1);
+
+		const int highestCardCount = std::ranges::max(countedCards);
+		const int pairCount = (int) std::ranges::count(countedCards, 2);
 
 		switch (highestCardCount)
 		{
@@ -102,7 +103,7 @@ struct Game07
 		}
 	}
 
-	void bumpHandValue()
+	constexpr void bumpHandValue()
 	{
 		switch (hand)
 		{
@@ -117,7 +118,7 @@ struct Game07
 		}
 	}
 
-	bool operator<(const Game07& rhs) const
+	constexpr bool operator<(const Game07& rhs) const
 	{
 		if (hand != rhs.hand)
 			return hand < rhs.hand;
@@ -144,45 +145,33 @@ struct Game07
 		return "<Unknown>";
 	}
 
-	void printHand() const
+	std::string describeHand() const
 	{
-		std::cout << cardsAsString << ": " << toString(hand) << std::endl;
+		return cardsAsString + ": " + toString(hand);
 	}
 };
 
-static auto loadData(const char* filename)
+static constexpr std::vector<Game07> loadData(std::string_view input)
 {
-	std::fstream s{ filename, s.in };
-	assert(s.is_open());
-
 	std::vector<Game07> games;
 
-	while (s.peek() != EOF)
+	for (const std::string_view line : aoc::lines(input))
 	{
-		std::string line;
-		std::getline(s, line);
 		assert(line.size() > 0);
 
-		std::string cards;
-		int bid = -1;
-
-		for (const auto word : std::views::split(line, ' '))
-		{
-			const std::string token(&*word.begin(), std::ranges::distance(word));
+		const size_t pos = line.find(' ');
+		assert(pos != std::string_view::npos);
 
-			if (cards.size() == 0)
-				cards = token;
-			else
-				bid = std::stoi(token);
-		}
+		const std::string_view cards = line.substr(0, pos);
+		std::string_view bid = line.substr(pos + 1);
 
-		games.emplace_back(cards, bid);
+		games.emplace_back(cards, (uint32_t) aoc::consumeNumber(bid));
 	}
 
 	return games;
 }
 
-static uint64_t calculateWinnings(const auto& data)
+static constexpr uint64_t calculateWinnings(const auto& data)
 {
 	uint64_t money = 0;
 
@@ -192,51 +181,84 @@ static uint64_t calculateWinnings(const auto& data)
 	return money;
 }
 
-static uint64_t partOne(auto& games)
+static constexpr uint64_t rankPartOne(auto& games)
 {
 	for (auto& game : games)
 		game.evaluatePart1();
 
 	std::sort(begin(games), end(games));
 
-	std::cout << "------ Part One ------" << std::endl;
-	for (auto& game : games)
-		game.printHand();
-
 	return calculateWinnings(games);
 }
 
-static uint64_t partTwo(auto& games)
+static constexpr uint64_t rankPartTwo(auto& games)
 {
 	for (auto& game : games)
 		game.evaluatePart2();
 
 	std::sort(begin(games), end(games));
 
-	std::cout << "------ Part Two ------" << std::endl;
-	for (auto& game : games)
-		game.printHand();
-
 	return calculateWinnings(games);
 }
 
-static std::pair<uint64_t, uint64_t> process(const char* filename)
+static uint64_t partOne(auto& games)
 {
-	auto games = loadData(filename);
-	return std::make_pair(partOne(games), partTwo(games));
+	const uint64_t winnings = rankPartOne(games);
+
+	if (aoc::diagnostics().isEnabled(aoc::Verbosity::Detail))
+		for (auto& game : games)
+			aoc::diagnostics().write(aoc::Verbosity::Detail, "day07.partone", game.describeHand());
+
+	return winnings;
+}
+
+static uint64_t partTwo(auto& games)
+{
+	const uint64_t winnings = rankPartTwo(games);
+
+	if (aoc::diagnostics().isEnabled(aoc::Verbosity::Detail))
+		for (auto& game : games)
+			aoc::diagnostics().write(aoc::Verbosity::Detail, "day07.parttwo", game.describeHand());
+
+	return winnings;
 }
 
+aoc::Answers<> aoc::solveDay07(std::string_view input)
+{
+	auto games = loadData(input);
+	const uint64_t pt1 = partOne(games);
+	const uint64_t pt2 = partTwo(games);
+	return { pt1, pt2 };
+}
+
+static constexpr aoc::Answers<> rankAndCalculateWinnings(std::string_view input)
+{
+	auto games = loadData(input);
+	const uint64_t pt1 = rankPartOne(games);
+	const uint64_t pt2 = rankPartTwo(games);
+	return { pt1, pt2 };
+}
+
+// Copy of data/07/test.txt, checked at compile time.
+static constexpr std::string_view testInput =
+R"(32T3K 765
+T55J5 684
+KK677 28
+KTJJT 220
+QQQJA 483)";
+
+static_assert(rankAndCalculateWinnings(testInput) == aoc::Answers<>{ 6440, 5905 });
+
 static void processPrintAndAssert(const char* filename, std::optional<std::pair<uint64_t, uint64_t>> expected = {})
 {
-	const auto result = process(filename);
-	std::cout << "Part 1: " << result.first << " Part 2: " << result.second << std::endl;
+	const auto result = aoc::solveDay07(aoc::readFile(filename));
+	std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
 
-	assert(!expected || expected.value().first == 0 || result.first == expected.value().first);
-	assert(!expected || expected.value().second == 0 || result.second == expected.value().second);
+	assert(!expected || expected.value().first == 0 || result.partOne == expected.value().first);
+	assert(!expected || expected.value().second == 0 || result.partTwo == expected.value().second);
 }
 
 void day07()
 {
-	processPrintAndAssert("../data/07/test.txt", std::make_pair(6440ull, 5905ull));
 	processPrintAndAssert("../data/07/real.txt", std::make_pair(250951660ull, 251481660ull));
 }
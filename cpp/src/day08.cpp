@@ -1,15 +1,19 @@
 #include <algorithm>
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <numeric>
 #include <optional>
 #include <ranges>
 #include <set>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
+#include "aoc.h"
+#include "diagnostics.h"
+#include "input.h"
+
 struct Node08
 {
 	std::string left;
@@ -39,17 +43,19 @@ struct NumSteps
 
 	std::unordered_map<std::string, Stats> nodeStats;
 	
-	void print() const
+	std::string describe() const
 	{
-		std::cout << from << " to " << to << ": ";
+		std::ostringstream out;
+
+		out << from << " to " << to << ": ";
 
 		if (stepCounts.size() == 0)
-			std::cout << "Unreachable";
+			out << "Unreachable";
 		else
 			for (auto& stepCount : stepCounts)
-				std::cout << "[" << stepCount.first << ", " << stepCount.second << "]";
+				out << "[" << stepCount.first << ", " << stepCount.second << "]";
 
-		std::cout << " Cycle start: { "
+		out << " Cycle start: { "
 			<< "key: " << startCycleKey << ", "
 			<< "instruction: " << startCycleInstructionIndex << ", "
 			<< "step count at cycle: " << startCycleStepCount;
@@ -57,11 +63,11 @@ struct NumSteps
 		//if (stepCounts.size() != 0)
 		//	if (nodeStats.contains(startCycleKey))
 		//		for (auto& seen : nodeStats.at(startCycleKey).seen)
-		//			std::cout << "[" << seen.first << ", " << seen.second << "]";
+		//			out << "[" << seen.first << ", " << seen.second << "]";
 
-		std::cout << " }";
+		out << " }";
 
-		std::cout << std::endl;
+		return out.str();
 	}
 
 	bool isReachable() const
@@ -118,7 +124,7 @@ struct Graph08
 		return steps.size() > 0 ? steps.front().second : UINT64_MAX;
 	}
 
-	uint64_t partTwoNumSteps() const
+	uint64_t partTwoNumSteps(const aoc::SolveContext& context) const
 	{
 		/*
 		* This is too slow.
@@ -146,19 +152,25 @@ struct Graph08
 
 		assert(aKeys.size() <= zKeys.size());
 
-		std::cout << "--- Part Two Analysis ---" << std::endl;
-		std::cout << "Instruction count: " << instructions.size() << std::endl;
+		const bool logDetail = aoc::diagnostics().isEnabled(aoc::Verbosity::Detail);
+
+		aoc::diagnostics().write(aoc::Verbosity::Summary, "day08", "Instruction count: " + std::to_string(instructions.size()));
 
 		std::vector<NumSteps> reachable;
 
-		for (const std::string& a : aKeys)
+		for (size_t i = 0; i < aKeys.size(); ++i)
 		{
-			numStepsUntilCycle(a, a).print();
+			const std::string& a = aKeys[i];
+			context.checkpoint("Finding cycles", i, aKeys.size());
+
+			if (logDetail)
+				aoc::diagnostics().write(aoc::Verbosity::Detail, "day08", numStepsUntilCycle(a, a).describe());
 
 			for (const std::string& z : zKeys)
 			{
 				auto steps = numStepsUntilCycle(a, z);
-				steps.print();
+				if (logDetail)
+					aoc::diagnostics().write(aoc::Verbosity::Detail, "day08", steps.describe());
 				if (steps.isReachable())
 					reachable.push_back(std::move(steps));
 			}
@@ -193,8 +205,15 @@ struct Graph08
 			);
 		};
 
+		static constexpr uint64_t checkpointInterval = 1 << 20;
+		uint64_t numAdvances = 0;
+
 		while (!allSame())
 		{
+			// The answer isn't known up front, so report the smallest step count reached so far.
+			if (++numAdvances % checkpointInterval == 0)
+				context.checkpoint("Advancing paths", *std::min_element(begin(currentStepCount), end(currentStepCount)));
+
 			size_t index = SIZE_MAX;
 			size_t minCount = SIZE_MAX;
 			for (size_t i = 0; i < currentStepCount.size(); ++i)
@@ -214,18 +233,12 @@ struct Graph08
 	}
 };
 
-static auto loadData(const char* filename)
+static auto loadData(std::string_view input)
 {
-	std::fstream s{ filename, s.in };
-	assert(s.is_open());
-
 	Graph08 graph;
 
-	while (s.peek() != EOF)
+	for (const std::string_view line : aoc::lines(input))
 	{
-		std::string line;
-		std::getline(s, line);
-
 		if (graph.instructions.size() == 0)
 		{
 			for (const char c : line)
@@ -266,24 +279,24 @@ static uint64_t partOne(const Graph08& graph)
 	return graph.numStepsPartOne();
 }
 
-static uint64_t partTwo(const Graph08& graph)
+static uint64_t partTwo(const Graph08& graph, const aoc::SolveContext& context)
 {
-	return graph.partTwoNumSteps();
+	return graph.partTwoNumSteps(context);
 }
 
-static std::pair<uint64_t, uint64_t> process(const char* filename)
+aoc::Answers<> aoc::solveDay08(std::string_view input, const SolveContext& context)
 {
-	const auto data = loadData(filename);
-	return std::make_pair(partOne(data), partTwo(data));
+	const auto data = loadData(input);
+	return { partOne(data), partTwo(data, context) };
 }
 
 static void processPrintAndAssert(const char* filename, std::optional<std::pair<uint64_t, uint64_t>> expected = {})
 {
-	const auto result = process(filename);
-	std::cout << "Part 1: " << result.first << " Part 2: " << result.second << std::endl;
+	const auto result = aoc::solveDay08(aoc::readFile(filename));
+	std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
 
-	assert(!expected || expected.value().first == 0 || result.first == expected.value().first);
-	assert(!expected || expected.value().second == 0 || result.second == expected.value().second);
+	assert(!expected || expected.value().first == 0 || result.partOne == expected.value().first);
+	assert(!expected || expected.value().second == 0 || result.partTwo == expected.value().second);
 }
 
 void day08()
@@ -1,6 +1,5 @@
 #include <algorithm>
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <numeric>
 #include <optional>
@@ -9,6 +8,9 @@
 #include <vector>
 #include <unordered_map>
 
+#include "aoc.h"
+#include "input.h"
+
 struct Data09
 {
 	std::vector<std::vector<int>> numberRows;
@@ -16,7 +18,7 @@ struct Data09
 	std::vector<int> extrapolated;
 	std::vector<int> backExtrapolated;
 
-	void resolveDifferences()
+	constexpr void resolveDifferences()
 	{
 		for (auto& numRow : numberRows)
 		{
@@ -47,7 +49,7 @@ struct Data09
 		}
 	}
 
-	void resolveExtrapolated()
+	constexpr void resolveExtrapolated()
 	{
 		for (auto& differencesForRow : differences)
 		{
@@ -62,7 +64,7 @@ struct Data09
 		}
 	}
 
-	void resolveBackExtrapolated()
+	constexpr void resolveBackExtrapolated()
 	{
 		for (auto& differencesForRow : differences)
 		{
@@ -78,26 +80,18 @@ struct Data09
 	}
 };
 
-static auto loadData(const char* filename)
+static constexpr Data09 loadData(std::string_view input)
 {
-	std::fstream s{ filename, s.in };
-	assert(s.is_open());
-
 	Data09 data;
 
-	while (s.peek() != EOF)
+	for (std::string_view line : aoc::lines(input))
 	{
-		std::string line;
-		std::getline(s, line);
 		assert(line.size() > 0);
 
 		data.numberRows.push_back({});
 
-		for (const auto word : std::views::split(line, ' '))
-		{
-			const std::string token(&*word.begin(), std::ranges::distance(word));
-			data.numberRows.back().push_back(std::stoi(token));
-		}
+		while (aoc::skipToNumber(line))
+			data.numberRows.back().push_back((int) aoc::consumeNumber(line));
 	}
 
 	data.resolveDifferences();
@@ -107,7 +101,7 @@ static auto loadData(const char* filename)
 	return data;
 }
 
-static int partOne(const Data09& data)
+static constexpr int partOne(const Data09& data)
 {
 	return std::accumulate(
 		begin(data.extrapolated),
@@ -117,7 +111,7 @@ static int partOne(const Data09& data)
 	);
 }
 
-static int partTwo(const Data09& data)
+static constexpr int partTwo(const Data09& data)
 {
 	return std::accumulate(
 		begin(data.backExtrapolated),
@@ -127,23 +121,35 @@ static int partTwo(const Data09& data)
 	);
 }
 
-static std::pair<int, int> process(const char* filename)
+static constexpr aoc::Answers<int> process(std::string_view input)
 {
-	const auto data = loadData(filename);
-	return std::make_pair(partOne(data), partTwo(data));
+	const auto data = loadData(input);
+	return { partOne(data), partTwo(data) };
 }
 
+aoc::Answers<int> aoc::solveDay09(std::string_view input)
+{
+	return process(input);
+}
+
+// Copy of data/09/test.txt, checked at compile time.
+static constexpr std::string_view testInput =
+R"(0 3 6 9 12 15
+1 3 6 10 15 21
+10 13 16 21 30 45)";
+
+static_assert(process(testInput) == aoc::Answers<int>{ 114, 2 });
+
 static void processPrintAndAssert(const char* filename, std::optional<std::pair<int, int>> expected = {})
 {
-	const auto result = process(filename);
-	std::cout << "Part 1: " << result.first << " Part 2: " << result.second << std::endl;
+	const auto result = aoc::solveDay09(aoc::readFile(filename));
+	std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
 
-	assert(!expected || expected.value().first == 0 || result.first == expected.value().first);
-	assert(!expected || expected.value().second == 0 || result.second == expected.value().second);
+	assert(!expected || expected.value().first == 0 || result.partOne == expected.value().first);
+	assert(!expected || expected.value().second == 0 || result.partTwo == expected.value().second);
 }
 
 void day09()
 {
-	processPrintAndAssert("../data/09/test.txt", std::make_pair(114, 2));
 	processPrintAndAssert("../data/09/real.txt", std::make_pair(1772145754, 867));
 }
@@ -1,6 +1,5 @@
 #include <algorithm>
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <numeric>
 #include <optional>
@@ -10,119 +9,87 @@
 #include <vector>
 #include <unordered_map>
 
+#include "aoc.h"
+#include "grid.h"
+#include "input.h"
+
 namespace d10
 {
-	struct Pos
-	{
-		int x = -1;
-		int y = -1;
-
-		bool isValid() const { return x != -1 && y != -1; }
-
-		auto operator<=>(const Pos&) const = default;
-
-		Pos left()  const { assert(isValid()); return { x - 1, y }; }
-		Pos right() const { assert(isValid()); return { x + 1, y }; }
-		Pos above() const { assert(isValid()); return { x, y - 1 }; }
-		Pos below() const { assert(isValid()); return { x, y + 1 }; }
-	};
+	using aoc::Cell;
+	using aoc::NoCell;
 
 	struct Pipe
 	{
-		Pos pos;
-		Pos neighbour1;
-		Pos neighbour2;
+		Cell neighbour1 = NoCell;
+		Cell neighbour2 = NoCell;
+
+		bool isValid() const { return neighbour1 != NoCell; }
 
-		bool isValid() const { return pos.isValid(); }
-		
 		bool isConnected() const
 		{
-			return neighbour1.isValid()
-				&& neighbour2.isValid(); 
+			return neighbour1 != NoCell
+				&& neighbour2 != NoCell;
 		}
 
-		bool isConnectedTo(const Pos& p) const
+		bool isConnectedTo(Cell c) const
 		{
-			return neighbour1 == p
-				|| neighbour2 == p;
+			return neighbour1 == c
+				|| neighbour2 == c;
 		}
 
-		Pos getNextNeighbour(const Pos& prev) const
+		Cell getNextNeighbour(Cell prev) const
 		{
 			assert(neighbour1 == prev || neighbour2 == prev);
 			return neighbour1 == prev ? neighbour2 : neighbour1;
 		}
-
-		Pos left()  const { return pos.left(); }
-		Pos right() const { return pos.right(); }
-		Pos above() const { return pos.above(); }
-		Pos below() const { return pos.below(); }
 	};
 
 	struct Graph
 	{
-		std::vector<std::vector<Pipe>> pipes;
-		Pos start;
-
-		bool isValidPos(const Pos& pos) const
-		{
-			return pos.isValid()
-				&& pos.y < (int) pipes.size()
-				&& pos.x < (int) pipes.front().size();
-		}
+		aoc::Grid<Pipe> pipes;
+		Cell start = NoCell;
 
-		const Pipe& getPipe(const Pos& pos) const
-		{
-			assert(isValidPos(pos));
-			return pipes[pos.y][pos.x];
-		}
-
-		Pipe& getPipe(const Pos& pos)
-		{
-			assert(isValidPos(pos));
-			return pipes[pos.y][pos.x];
-		}
+		const aoc::GridLayout& layout() const { return pipes.layout; }
 
 		void removeJunkPipes()
 		{
-			Pos prevPos = start;
-			Pos pos = getPipe(prevPos).neighbour1;
+			Cell prev = start;
+			Cell cell = pipes[prev].neighbour1;
 
-			std::set<Pos> mainLoop;
+			std::vector<uint8_t> isMainLoop(layout().numCells(), 0);
 
-			while (mainLoop.insert(pos).second)
+			while (!isMainLoop[cell])
 			{
-				const Pipe& pipe = getPipe(pos);
-				const Pos nextPos = pipe.getNextNeighbour(prevPos);
-				prevPos = pos;
-				pos = nextPos;
+				isMainLoop[cell] = 1;
+
+				const Cell next = pipes[cell].getNextNeighbour(prev);
+				prev = cell;
+				cell = next;
 			}
 
-			for (auto& row : pipes)
+			for (Cell c = 0; c < layout().numCells(); ++c)
 			{
-				for (Pipe& pipe : row)
-				{
-					if (pipe.isValid() && !mainLoop.contains(pipe.pos))
-						pipe = Pipe();
-				}
+				if (!isMainLoop[c])
+					pipes[c] = Pipe();
 			}
 		}
 
-		bool isInsidePipeLoop(const Pos& pos) const
+		bool isInsidePipeLoop(Cell cell) const
 		{
 			// Raycast left and count how many pipe crossings there are.
 			// An odd number of crossings means we're inside the loop.
 			int crossings = 0;
 
-			Pos leftPipePos = pos.left();
+			const Cell rowStart = layout().cell(0, layout().y(cell));
+			Cell leftPipeCell = layout().left(cell);
 
-			while (leftPipePos.isValid())
+			while (leftPipeCell >= rowStart)
 			{
-				const Pipe* leftPipe = &getPipe(leftPipePos);
-				if (!leftPipe->isValid())
+				const Pipe& leftPipe = pipes[leftPipeCell];
+				if (!leftPipe.isValid())
 				{
 					// keep advancing left until hitting a pipe
-					leftPipePos = leftPipePos.left();
+					leftPipeCell = layout().left(leftPipeCell);
 					continue;
 				}
 
@@ -131,108 +98,95 @@ namespace d10
 				// If they're the same direction then the pipe was not crossed
 				// (i.e., we're still on the same side of the loop)
 				// e.g., LJ does not cross but FJ does.
-				const bool goesDown = leftPipe->isConnectedTo(leftPipe->below());
+				const bool goesDown = leftPipe.isConnectedTo(layout().down(leftPipeCell));
 
-				const Pipe* lastPipe = leftPipe;
-				while (lastPipe->isConnectedTo(lastPipe->left()))
-					lastPipe = &getPipe(lastPipe->left());
+				Cell lastPipeCell = leftPipeCell;
+				while (pipes[lastPipeCell].isConnectedTo(layout().left(lastPipeCell)))
+					lastPipeCell = layout().left(lastPipeCell);
 
-				if (lastPipe == leftPipe)
+				if (lastPipeCell == leftPipeCell)
 					crossings++; // Pipe was a vertical pipe
-				else if (lastPipe->isConnectedTo(lastPipe->below()) != goesDown)
+				else if (pipes[lastPipeCell].isConnectedTo(layout().down(lastPipeCell)) != goesDown)
 					crossings++; // Pipe end goes in a different direction than the start
 
-				leftPipePos = lastPipe->left();
+				leftPipeCell = layout().left(lastPipeCell);
 			}
 
 			return (crossings % 2) == 1;
 		}
 	};
 
-	auto loadData(const char* filename)
+	auto loadData(std::string_view input)
 	{
-		std::fstream s{ filename, s.in };
-		assert(s.is_open());
+		const aoc::Grid<char> chars = aoc::loadCharGrid(input, '.');
+		const aoc::GridLayout& layout = chars.layout;
 
 		Graph graph;
+		graph.pipes = aoc::Grid<Pipe>(layout);
 
-		while (s.peek() != EOF)
+		for (Cell cell = 0; cell < layout.numCells(); ++cell)
 		{
-			std::string line;
-			std::getline(s, line);
-			assert(line.size() > 0);
+			Pipe& pipe = graph.pipes[cell];
 
-			const int row = (int) graph.pipes.size();
-
-			graph.pipes.push_back({});
-			std::vector<Pipe>& pipes = graph.pipes.back();
-			pipes.resize(line.size());
-
-			for (int col = 0; col < (int) line.size(); ++col)
+			switch (chars[cell])
 			{
-				Pipe& pipe = pipes[col];
-				pipe.pos = { col, row };
-
-				switch (line[col])
-				{
-					case '.': 
-						break;
-
-					case 'S':
-						graph.start = pipe.pos;
-						break;
-
-					case '-':
-						pipe.neighbour1 = pipe.left();
-						pipe.neighbour2 = pipe.right();
-						break;
-
-					case '|':
-						pipe.neighbour1 = pipe.above();
-						pipe.neighbour2 = pipe.below();
-						break;
-
-					case '7':
-						pipe.neighbour1 = pipe.left();
-						pipe.neighbour2 = pipe.below();
-						break;
-
-					case 'J':
-						pipe.neighbour1 = pipe.left();
-						pipe.neighbour2 = pipe.above();
-						break;
-
-					case 'L':
-						pipe.neighbour1 = pipe.above();
-						pipe.neighbour2 = pipe.right();
-						break;
-
-					case 'F':
-						pipe.neighbour1 = pipe.below();
-						pipe.neighbour2 = pipe.right();
-						break;
-
-					default:
-						assert(false);
-						break;
-				}
+				case '.': 
+					break;
+
+				case 'S':
+					graph.start = cell;
+					break;
+
+				case '-':
+					pipe.neighbour1 = layout.left(cell);
+					pipe.neighbour2 = layout.right(cell);
+					break;
+
+				case '|':
+					pipe.neighbour1 = layout.up(cell);
+					pipe.neighbour2 = layout.down(cell);
+					break;
+
+				case '7':
+					pipe.neighbour1 = layout.left(cell);
+					pipe.neighbour2 = layout.down(cell);
+					break;
+
+				case 'J':
+					pipe.neighbour1 = layout.left(cell);
+					pipe.neighbour2 = layout.up(cell);
+					break;
+
+				case 'L':
+					pipe.neighbour1 = layout.up(cell);
+					pipe.neighbour2 = layout.right(cell);
+					break;
+
+				case 'F':
+					pipe.neighbour1 = layout.down(cell);
+					pipe.neighbour2 = layout.right(cell);
+					break;
+
+				default:
+					assert(false);
+					break;
 			}
 		}
 
-		assert(graph.start.isValid());
+		assert(graph.start != NoCell);
 
-		Pipe& startPipe = graph.getPipe(graph.start);
+		Pipe& startPipe = graph.pipes[graph.start];
 
-		auto setStartNeighbourIfConnected = [&graph, &startPipe] (const Pos& pos)
+		auto setStartNeighbourIfConnected = [&graph, &startPipe] (Cell cell)
 		{
-			if (graph.isValidPos(pos) && graph.getPipe(pos).isConnectedTo(graph.start))
-				(startPipe.neighbour1.isValid() ? startPipe.neighbour2 : startPipe.neighbour1) = pos;
+			if (graph.pipes[cell].isConnectedTo(graph.start))
+				(startPipe.neighbour1 != NoCell ? startPipe.neighbour2 : startPipe.neighbour1) = cell;
 		};
 
-		setStartNeighbourIfConnected(startPipe.left());
-		setStartNeighbourIfConnected(startPipe.right());
-		setStartNeighbourIfConnected(startPipe.above());
-		setStartNeighbourIfConnected(startPipe.below());
+		setStartNeighbourIfConnected(layout.left(graph.start));
+		setStartNeighbourIfConnected(layout.right(graph.start));
+		setStartNeighbourIfConnected(layout.up(graph.start));
+		setStartNeighbourIfConnected(layout.down(graph.start));
 
 		assert(startPipe.isConnected());
 
@@ -246,16 +200,15 @@ static uint64_t partOne(const d10::Graph& graph)
 {
 	using namespace d10;
 
-	Pos prevPos = graph.start;
-	Pos pos = graph.getPipe(prevPos).neighbour1;
+	Cell prev = graph.start;
+	Cell cell = graph.pipes[prev].neighbour1;
 	uint64_t stepsToLoop = 1;
 
-	while (pos != graph.start)
+	while (cell != graph.start)
 	{
-		const Pipe& pipe = graph.getPipe(pos);
-		const Pos nextPos = pipe.getNextNeighbour(prevPos);
-		prevPos = pos;
-		pos = nextPos;
+		const Cell next = graph.pipes[cell].getNextNeighbour(prev);
+		prev = cell;
+		cell = next;
 		++stepsToLoop;
 	}
 
@@ -267,17 +220,19 @@ static uint64_t partTwo(const d10::Graph& graph)
 {
 	using namespace d10;
 
+	const aoc::GridLayout& layout = graph.layout();
+
 	uint64_t numInside = 0;
 
-	for (int row = 0; row < (int) graph.pipes.size(); ++row)
+	for (uint32_t row = 0; row < layout.getHeight(); ++row)
 	{
 		bool wasPipe = false;
 		bool inside = false;
 
-		for (int col = 0; col < (int) graph.pipes.front().size(); ++col)
+		for (uint32_t col = 0; col < layout.getWidth(); ++col)
 		{
-			const Pos pos = { col, row };
-			const Pipe& pipe = graph.getPipe(pos);
+			const Cell cell = layout.cell(col, row);
+			const Pipe& pipe = graph.pipes[cell];
 			if (pipe.isValid())
 			{
 				wasPipe = true;
@@ -286,7 +241,7 @@ static uint64_t partTwo(const d10::Graph& graph)
 
 			// boundary change - test if region is inside or outside the loop, and cache while we count this row.
 			if (wasPipe)
-				inside = graph.isInsidePipeLoop(pos);
+				inside = graph.isInsidePipeLoop(cell);
 
 			numInside += inside;
 			wasPipe = pipe.isValid();
@@ -296,19 +251,19 @@ static uint64_t partTwo(const d10::Graph& graph)
 	return numInside;
 }
 
-static std::pair<uint64_t, uint64_t> process(const char* filename)
+aoc::Answers<> aoc::solveDay10(std::string_view input)
 {
-	const auto data = d10::loadData(filename);
-	return std::make_pair(partOne(data), partTwo(data));
+	const auto data = d10::loadData(input);
+	return { partOne(data), partTwo(data) };
 }
 
 static void processPrintAndAssert(const char* filename, std::optional<std::pair<uint64_t, uint64_t>> expected = {})
 {
-	const auto result = process(filename);
-	std::cout << "Part 1: " << result.first << " Part 2: " << result.second << std::endl;
+	const auto result = aoc::solveDay10(aoc::readFile(filename));
+	std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
 
-	assert(!expected || expected.value().first == 0 || result.first == expected.value().first);
-	assert(!expected || expected.value().second == 0 || result.second == expected.value().second);
+	assert(!expected || expected.value().first == 0 || result.partOne == expected.value().first);
+	assert(!expected || expected.value().second == 0 || result.partTwo == expected.value().second);
 }
 
 void day10()
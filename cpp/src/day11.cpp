@@ -1,6 +1,5 @@
 #include <algorithm>
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <numeric>
@@ -11,35 +10,22 @@
 #include <vector>
 #include <unordered_map>
 
-namespace d11
-{
+#include "aoc.h"
+#include "grid.h"
+#include "input.h"
 
-struct Vec2
+namespace d11
 {
-	int64_t x = 0;
-	int64_t y = 0;
-
-	friend Vec2 operator-(const Vec2& lhs, const Vec2& rhs)
-	{
-		return {lhs.x - rhs.x, lhs.y - rhs.y};
-	}
-
-	static int64_t manhattanDistance(const Vec2& lhs, const Vec2& rhs)
-	{
-		const Vec2 diff = rhs - lhs;
-		return abs(diff.x) + abs(diff.y);
-	}
-};
 
 struct Galaxy
 {
 	int64_t id = 0;
-	Vec2 pos;
+	aoc::Cell pos = aoc::NoCell;
 };
 
 struct GalaxyMap
 {
-	std::vector<std::vector<bool>> grid;
+	aoc::Grid<char> grid;
 	std::vector<Galaxy> galaxies;
 	std::map<std::pair<int64_t, int64_t>, int64_t> manhattanDistancesPt1;
 	std::map<std::pair<int64_t, int64_t>, int64_t> manhattanDistancesPt2;
@@ -50,37 +36,25 @@ struct GalaxyMap
 	int64_t pt1EmptyScale = 0;
 	int64_t pt2EmptyScale = 0;
 
-	explicit GalaxyMap(const char* filename, int64_t _pt1EmptyScale, int64_t _pt2EmptyScale)
+	explicit GalaxyMap(std::string_view input, int64_t _pt1EmptyScale, int64_t _pt2EmptyScale)
 		: pt1EmptyScale(_pt1EmptyScale)
 		, pt2EmptyScale(_pt2EmptyScale)
 	{
-		load(filename);
+		load(input);
 		expandSpace();
 		identifyGalaxies();
 		calculateManhattanDistances();
 	}
 
 private:
-	void load(const char* filename)
+	void load(std::string_view input)
 	{
-		std::fstream s{ filename, s.in };
-		assert(s.is_open());
-
-		while (s.peek() != EOF)
-		{
-			std::string line;
-			std::getline(s, line);
-			assert(line.size() > 0);
-
-			grid.push_back({});
-			auto& row = grid.back();
-
-			for (const char c : line)
-				row.push_back(c == '#');
-		}
+		grid = aoc::loadCharGrid(input, '.');
+	}
 
-		for (auto& row : grid)
-			assert(row.size() == grid.front().size());
+	bool isGalaxy(uint32_t col, uint32_t row) const
+	{
+		return grid[grid.layout.cell(col, row)] == '#';
 	}
 
 	void expandSpace()
@@ -88,16 +62,19 @@ private:
 		std::set<size_t> populatedRows;
 		std::set<size_t> populatedCols;
 
-		for (size_t row = 0; row < grid.size(); ++row)
-			for (size_t col = 0; col < grid.front().size(); ++col)
-				if (grid[row][col])
+		const uint32_t width = grid.layout.getWidth();
+		const uint32_t height = grid.layout.getHeight();
+
+		for (uint32_t row = 0; row < height; ++row)
+			for (uint32_t col = 0; col < width; ++col)
+				if (isGalaxy(col, row))
 					(populatedRows.insert(row), populatedCols.insert(col));
 
-		for (size_t row = 0; row < grid.size(); ++row)
+		for (size_t row = 0; row < height; ++row)
 			if (!populatedRows.contains(row))
 				emptyRows.push_back((int64_t) row);
 
-		for (size_t col = 0; col < grid.front().size(); ++col)
+		for (size_t col = 0; col < width; ++col)
 			if (!populatedCols.contains(col))
 				emptyCols.push_back((int64_t) col);
 
@@ -109,14 +86,16 @@ private:
 	{
 		int64_t id = 0;
 
-		for (size_t row = 0; row < grid.size(); ++row)
-			for (size_t col = 0; col < grid.front().size(); ++col)
-				if (grid[row][col])
-					galaxies.push_back({ id++, Vec2{(int64_t) col, (int64_t) row} });
+		for (uint32_t row = 0; row < grid.layout.getHeight(); ++row)
+			for (uint32_t col = 0; col < grid.layout.getWidth(); ++col)
+				if (isGalaxy(col, row))
+					galaxies.push_back({ id++, grid.layout.cell(col, row) });
 	}
 
 	void calculateManhattanDistances()
 	{
+		const aoc::GridLayout& layout = grid.layout;
+
 		for (size_t i = 0; i < galaxies.size() - 1; ++i)
 		{
 			const Galaxy& g1 = galaxies[i];
@@ -126,11 +105,11 @@ private:
 				const Galaxy& g2 = galaxies[j];
 				assert(g1.id < g2.id);
 
-				const int64_t numEmptyRows = numEmptyCellsBetween(g1.pos.y, g2.pos.y, emptyRows);
-				const int64_t numEmptyCols = numEmptyCellsBetween(g1.pos.x, g2.pos.x, emptyCols);
+				const int64_t numEmptyRows = numEmptyCellsBetween(layout.y(g1.pos), layout.y(g2.pos), emptyRows);
+				const int64_t numEmptyCols = numEmptyCellsBetween(layout.x(g1.pos), layout.x(g2.pos), emptyCols);
 				const int64_t numEmptyCells = numEmptyRows + numEmptyCols;
 
-				const int64_t manDist = Vec2::manhattanDistance(g1.pos, g2.pos);
+				const int64_t manDist = layout.manhattanDistance(g1.pos, g2.pos);
 
 				manhattanDistancesPt1[{g1.id, g2.id}] = manDist + numEmptyCells * (pt1EmptyScale - 1);
 				manhattanDistancesPt2[{g1.id, g2.id}] = manDist + numEmptyCells * (pt2EmptyScale - 1);
@@ -169,21 +148,21 @@ static int64_t partTwo(const GalaxyMap& galaxyMap)
 	);
 }
 
-static std::pair<int64_t, int64_t> process(const char* filename, int64_t pt1Scale, int64_t pt2Scale)
+} // d11
+
+aoc::Answers<int64_t> aoc::solveDay11(std::string_view input, int64_t pt1EmptyScale, int64_t pt2EmptyScale)
 {
-	const GalaxyMap map(filename, pt1Scale, pt2Scale);
-	return std::make_pair(partOne(map), partTwo(map));
+	const d11::GalaxyMap map(input, pt1EmptyScale, pt2EmptyScale);
+	return { d11::partOne(map), d11::partTwo(map) };
 }
 
-} // d11
-
 static void processPrintAndAssert(const char* filename, int64_t pt1Scale, int64_t pt2Scale, std::optional<std::pair<int64_t, int64_t>> expected = {})
 {
-	const auto result = d11::process(filename, pt1Scale, pt2Scale);
-	std::cout << "Part 1: " << result.first << " Part 2: " << result.second << std::endl;
+	const auto result = aoc::solveDay11(aoc::readFile(filename), pt1Scale, pt2Scale);
+	std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
 
-	assert(!expected || expected.value().first == 0 || result.first == expected.value().first);
-	assert(!expected || expected.value().second == 0 || result.second == expected.value().second);
+	assert(!expected || expected.value().first == 0 || result.partOne == expected.value().first);
+	assert(!expected || expected.value().second == 0 || result.partTwo == expected.value().second);
 }
 
 void day11()
@@ -1,6 +1,5 @@
 #include <algorithm>
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <functional>
 #include <map>
@@ -12,6 +11,9 @@
 #include <vector>
 #include <unordered_map>
 
+#include "aoc.h"
+#include "input.h"
+
 namespace d12
 {
 	enum class CellState
@@ -128,23 +130,18 @@ namespace d12
 
 		Springs() = default;
 
-		explicit Springs(const char* filename)
+		explicit Springs(std::string_view input)
 		{
-			std::fstream s{ filename, s.in };
-			assert(s.is_open());
-
-			while (s.peek() != EOF)
+			for (const std::string_view line : aoc::lines(input))
 			{
-				std::string line;
-				std::getline(s, line);
 				assert(line.size() > 0);
 
 				rows.push_back({});
 				SpringRow& row = rows.back();
 
 				const size_t pos = line.find(' ');
-				const std::string damagedStr = line.substr(0, pos);
-				const std::string groupsStr = line.substr(pos + 1);
+				const std::string_view damagedStr = line.substr(0, pos);
+				const std::string_view groupsStr = line.substr(pos + 1);
 
 				for (const char c : damagedStr)
 				{
@@ -176,17 +173,20 @@ namespace d12
 			}
 		}
 
-		void evaluatePermutations()
+		void evaluatePermutations(const aoc::SolveContext& context, std::string_view stage)
 		{
-			for (auto& row : rows)
-				row.evaluatePermutations();
+			for (size_t i = 0; i < rows.size(); ++i)
+			{
+				context.checkpoint(stage, i, rows.size());
+				rows[i].evaluatePermutations();
+			}
 		}
 	};
 
-	static uint64_t partOne(const Springs& input)
+	static uint64_t partOne(const Springs& input, const aoc::SolveContext& context)
 	{
 		Springs springs = input;
-		springs.evaluatePermutations();
+		springs.evaluatePermutations(context, "Part one rows");
 
 		return std::accumulate(
 			begin(springs.rows),
@@ -196,7 +196,7 @@ namespace d12
 		);
 	}
 
-	static uint64_t partTwo(const Springs& input)
+	static uint64_t partTwo(const Springs& input, const aoc::SolveContext& context)
 	{
 		Springs springs;
 
@@ -224,7 +224,7 @@ namespace d12
 			}
 		}
 
-		springs.evaluatePermutations();
+		springs.evaluatePermutations(context, "Part two rows");
 
 		return std::accumulate(
 			begin(springs.rows),
@@ -234,22 +234,21 @@ namespace d12
 		);
 	}
 
-	static std::pair<uint64_t, uint64_t> process(const char* filename)
-	{
-		const Springs springs(filename);
-		const auto pt1 = partOne(springs);
-		const auto pt2 = partTwo(springs);
-		return std::make_pair(pt1, pt2);
-	}
+}
+
+aoc::Answers<> aoc::solveDay12(std::string_view input, const SolveContext& context)
+{
+	const d12::Springs springs(input);
+	return { d12::partOne(springs, context), d12::partTwo(springs, context) };
 }
 
 static void processPrintAndAssert(const char* filename, std::optional<std::pair<uint64_t, uint64_t>> expected = {})
 {
-	const auto result = d12::process(filename);
-	std::cout << "Part 1: " << result.first << " Part 2: " << result.second << std::endl;
+	const auto result = aoc::solveDay12(aoc::readFile(filename));
+	std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
 
-	assert(!expected || expected.value().first == 0 || result.first == expected.value().first);
-	assert(!expected || expected.value().second == 0 || result.second == expected.value().second);
+	assert(!expected || expected.value().first == 0 || result.partOne == expected.value().first);
+	assert(!expected || expected.value().second == 0 || result.partTwo == expected.value().second);
 }
 
 void day12()
@@ -1,6 +1,5 @@
 #include <algorithm>
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <functional>
 #include <map>
@@ -12,30 +11,44 @@
 #include <vector>
 #include <unordered_map>
 
+#include "aoc.h"
+#include "gridtransform.h"
+#include "input.h"
+
 namespace d13
 {
 	struct LavaMap
 	{
-		std::vector<std::string> cells;
+		// Row-major, without line breaks.
+		std::string cells;
+		size_t width = 0;
+		size_t height = 0;
 		size_t indexOfSymmetry = SIZE_MAX;
 
-		void validate() const
+		void addRow(std::string_view line)
 		{
-			for (auto& line : cells)
-				assert(line.size() == cells.front().size());
+			assert(width == 0 || line.size() == width);
+			width = line.size();
+			cells += line;
+			++height;
+		}
+
+		std::string_view row(size_t i) const
+		{
+			return std::string_view(cells).substr(i * width, width);
 		}
 
 		void evalLineOfSymmetry()
 		{
-			for (size_t i = 1; i < cells.size() && indexOfSymmetry == SIZE_MAX; ++i)
+			for (size_t i = 1; i < height && indexOfSymmetry == SIZE_MAX; ++i)
 			{
 				const size_t sum = i + i - 1;
 				bool foundSymmetry = true;
 
-				for (size_t j = i; j < cells.size() && j <= sum && foundSymmetry; ++j)
+				for (size_t j = i; j < height && j <= sum && foundSymmetry; ++j)
 				{
 					const size_t k = sum - j;
-					foundSymmetry &= (cells[j] == cells[k]);
+					foundSymmetry &= (row(j) == row(k));
 				}
 
 				if (foundSymmetry)
@@ -45,19 +58,19 @@ namespace d13
 
 		void fixSmudgeAndEvalSymmetry()
 		{
-			for (size_t i = 1; i < cells.size() && indexOfSymmetry == SIZE_MAX; ++i)
+			for (size_t i = 1; i < height && indexOfSymmetry == SIZE_MAX; ++i)
 			{
 				const size_t sum = i + i - 1;
 				std::pair<size_t, size_t> smudgePos;
 				int numDifferences = 0;
 
-				for (size_t j = i; j < cells.size() && j <= sum && numDifferences <= 1; ++j)
+				for (size_t j = i; j < height && j <= sum && numDifferences <= 1; ++j)
 				{
 					const size_t k = sum - j;
 
-					for (size_t c = 0; c < cells[j].size() && numDifferences <= 1; ++c)
+					for (size_t c = 0; c < width && numDifferences <= 1; ++c)
 					{
-						if (cells[j][c] != cells[k][c])
+						if (row(j)[c] != row(k)[c])
 						{
 							smudgePos = std::make_pair(j, c);
 							++numDifferences;
@@ -67,7 +80,7 @@ namespace d13
 
 				if (numDifferences == 1)
 				{
-					char& c = cells[smudgePos.first][smudgePos.second];
+					char& c = cells[(smudgePos.first * width) + smudgePos.second];
 					c = c == '#' ? '.' : '#';
 					indexOfSymmetry = i;
 				}
@@ -82,19 +95,13 @@ namespace d13
 
 		void transposeRowsToCols()
 		{
-			rows.validate();
-
-			for (size_t col = 0; col < rows.cells.front().size(); ++col)
-			{
-				cols.cells.push_back({});
-
-				for (const std::string& cells : rows.cells)
-				{
-					cols.cells.back().push_back(cells[col]);
-				}
-			}
+			cols.width = rows.height;
+			cols.height = rows.width;
+			cols.cells.resize(rows.cells.size());
 
-			cols.validate();
+			aoc::transpose(
+				{ rows.cells.data(), rows.width, rows.height, (ptrdiff_t) rows.width },
+				{ cols.cells.data(), cols.width, cols.height, (ptrdiff_t) cols.width });
 		}
 
 		void evalLinesOfSymmetry()
@@ -118,28 +125,22 @@ namespace d13
 	{
 		std::vector<LavaMaps> lavaMaps;
 
-		explicit AllLavaMaps(const char* filename)
+		explicit AllLavaMaps(std::string_view input)
 		{
-			loadRows(filename);
+			loadRows(input);
 			transposeRowsToCols();
 		}
 
-		void loadRows(const char* filename)
+		void loadRows(std::string_view input)
 		{
-			std::fstream s{ filename, s.in };
-			assert(s.is_open());
-
 			lavaMaps.push_back({});
 
-			while (s.peek() != EOF)
+			for (const std::string_view line : aoc::lines(input))
 			{
-				std::string line;
-				std::getline(s, line);
-
 				if (line.size() == 0)
 					lavaMaps.push_back({});
 				else
-					lavaMaps.back().rows.cells.push_back(line);
+					lavaMaps.back().rows.addRow(line);
 			}
 		}
 
@@ -200,22 +201,22 @@ namespace d13
 		);
 	}
 
-	static std::pair<uint64_t, uint64_t> process(const char* filename)
-	{
-		const AllLavaMaps maps(filename);
-		return std::make_pair(partOne(maps), partTwo(maps));
-	}
-
 	static void processPrintAndAssert(const char* filename, std::pair<uint64_t, uint64_t> expected)
 	{
-		const auto result = process(filename);
-		std::cout << "Part 1: " << result.first << " Part 2: " << result.second << std::endl;
+		const auto result = aoc::solveDay13(aoc::readFile(filename));
+		std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
 
-		assert(expected.first == 0 || result.first == expected.first);
-		assert(expected.second == 0 || result.second == expected.second);
+		assert(expected.first == 0 || result.partOne == expected.first);
+		assert(expected.second == 0 || result.partTwo == expected.second);
 	}
 }
 
+aoc::Answers<> aoc::solveDay13(std::string_view input)
+{
+	const d13::AllLavaMaps maps(input);
+	return { d13::partOne(maps), d13::partTwo(maps) };
+}
+
 void day13()
 {
 	d13::processPrintAndAssert("../data/13/test.txt", std::make_pair(405ull, 400ull));
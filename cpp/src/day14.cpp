@@ -1,6 +1,5 @@
 #include <algorithm>
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <functional>
 #include <map>
@@ -9,46 +8,54 @@
 #include <ranges>
 #include <set>
 #include <string>
+#include <tuple>
 #include <vector>
 #include <unordered_map>
 
+#include "aoc.h"
+#include "diagnostics.h"
+#include "gridtransform.h"
+#include "input.h"
+
 namespace d14
 {
 	struct Panel
 	{
-		std::vector<std::string> rows;
-		std::vector<std::string> buffer;
+		// Row-major, without line breaks.
+		std::string cells;
+		std::string buffer;
+		size_t width = 0;
+		size_t height = 0;
 
-		bool operator<(const Panel& rhs) const { return rows < rhs.rows; }
-		bool operator==(const Panel& rhs) const { return rows == rhs.rows; }
+		bool operator<(const Panel& rhs) const { return std::tie(width, cells) < std::tie(rhs.width, rhs.cells); }
+		bool operator==(const Panel& rhs) const { return width == rhs.width && cells == rhs.cells; }
 
-		explicit Panel(const char* filename)
+		explicit Panel(std::string_view input)
 		{
-			std::fstream s{ filename, s.in };
-			assert(s.is_open());
-
-			while (s.peek() != EOF)
+			for (const std::string_view line : aoc::lines(input))
 			{
-				std::string line;
-				std::getline(s, line);
 				assert(line.size() > 0);
-				rows.push_back(line);
+				assert(width == 0 || line.size() == width);
+				width = line.size();
+				cells += line;
+				++height;
 			}
 
-			buffer = rows;
+			buffer.resize(cells.size());
 		}
 
+		char& at(size_t row, size_t col) { return cells[(row * width) + col]; }
+		char at(size_t row, size_t col) const { return cells[(row * width) + col]; }
+
 		void tiltNorth()
 		{
-			std::vector<size_t> empty(rows.front().size(), 0);
+			std::vector<size_t> empty(width, 0);
 
-			for (size_t row = 0; row < rows.size(); ++row)
+			for (size_t row = 0; row < height; ++row)
 			{
-				const std::string& line = rows[row];
-
-				for (size_t col = 0; col < line.size(); ++col)
+				for (size_t col = 0; col < width; ++col)
 				{
-					switch (line[col])
+					switch (at(row, col))
 					{
 						case '.':
 							break;
@@ -60,7 +67,7 @@ namespace d14
 						case 'O':
 						{
 							size_t& emptyRow = empty[col];
-							std::swap(rows[emptyRow][col], rows[row][col]);
+							std::swap(at(emptyRow, col), at(row, col));
 							++emptyRow;
 							break;
 						}
@@ -71,14 +78,12 @@ namespace d14
 
 		void rotateClockwise90()
 		{
-			assert(rows.size() == rows.front().size());
-			const size_t len = rows.size();
-
-			for (size_t row = 0; row < len; ++row)
-				for (size_t col = 0; col < len; ++col)
-					buffer[col][len - row - 1] = rows[row][col];
+			aoc::rotateClockwise(
+				{ cells.data(), width, height, (ptrdiff_t) width },
+				{ buffer.data(), height, width, (ptrdiff_t) height });
 
-			std::swap(rows, buffer);
+			std::swap(cells, buffer);
+			std::swap(width, height);
 		}
 
 		void spinCycle()
@@ -90,26 +95,26 @@ namespace d14
 			}
 		}
 
-		uint64_t calculateLoad()
+		uint64_t calculateLoad() const
 		{
 			uint64_t load = 0;
 
-			const size_t len = rows.size();
-
-			for (size_t row = 0; row < len; ++row)
-				for (size_t col = 0; col < len; ++col)
-					if (rows[row][col] == 'O')
-						load += len - row;
+			for (size_t row = 0; row < height; ++row)
+				for (size_t col = 0; col < width; ++col)
+					if (at(row, col) == 'O')
+						load += height - row;
 
 			return load;
 		}
 
-		void print()
+		void print() const
 		{
-			for (auto& row : rows)
-				std::cout << row << std::endl;
+			std::string text;
 
-			std::cout << std::endl;
+			for (size_t row = 0; row < height; ++row)
+				(text += '\n') += std::string_view(cells).substr(row * width, width);
+
+			aoc::diagnostics().write(aoc::Verbosity::Detail, "day14.panel", text);
 		}
 	};
 
@@ -120,7 +125,7 @@ namespace d14
 		return p.calculateLoad();
 	}
 
-	static uint64_t partTwo(const Panel& panel)
+	static uint64_t partTwo(const Panel& panel, const aoc::SolveContext& context)
 	{
 		Panel p = panel;
 
@@ -133,6 +138,8 @@ namespace d14
 
 		for (size_t i = 0; i < numIters && !repeats; ++i)
 		{
+			context.checkpoint("Spin cycles until repeat", i);
+
 			uniquePanels.push_back(p);
 			p.spinCycle();
 
@@ -143,9 +150,8 @@ namespace d14
 		const size_t loopStart = repeatIter - begin(uniquePanels);
 		const size_t loopSize = uniquePanels.size() - loopStart;
 
-		std::cout << "Repeats after " << loopSize
-			<< " cycles looping back to " << loopStart
-			<< std::endl;
+		aoc::diagnostics().write(aoc::Verbosity::Summary, "day14",
+			"Repeats after " + std::to_string(loopSize) + " cycles looping back to " + std::to_string(loopStart));
 
 		const size_t finalPanelIndex = ((numIters - loopStart) % loopSize) + loopStart;
 		return uniquePanels[finalPanelIndex].calculateLoad();
@@ -153,16 +159,20 @@ namespace d14
 
 	static void processPrintAndAssert(const char* filename, std::pair<uint64_t, uint64_t> expected)
 	{
-		const Panel panel(filename);
-		const uint64_t pt1Result = partOne(panel);
-		const uint64_t pt2Result = partTwo(panel);
-		std::cout << "Part 1: " << pt1Result << " Part 2: " << pt2Result << std::endl;
+		const auto result = aoc::solveDay14(aoc::readFile(filename));
+		std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
 
-		assert(expected.first == 0 || pt1Result == expected.first);
-		assert(expected.second == 0 || pt2Result == expected.second);
+		assert(expected.first == 0 || result.partOne == expected.first);
+		assert(expected.second == 0 || result.partTwo == expected.second);
 	}
 }
 
+aoc::Answers<> aoc::solveDay14(std::string_view input, const SolveContext& context)
+{
+	const d14::Panel panel(input);
+	return { d14::partOne(panel), d14::partTwo(panel, context) };
+}
+
 void day14()
 {
 	d14::processPrintAndAssert("../data/14/test.txt", std::make_pair(136ull, 64ull));
@@ -1,6 +1,5 @@
 #include <algorithm>
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <functional>
 #include <map>
@@ -12,9 +11,12 @@
 #include <vector>
 #include <unordered_map>
 
+#include "aoc.h"
+#include "input.h"
+
 namespace d15
 {
-	static uint64_t lavaHash(const std::string& str)
+	static constexpr uint64_t lavaHash(std::string_view str)
 	{
 		return std::accumulate(
 			begin(str),
@@ -29,7 +31,7 @@ namespace d15
 		std::string label;
 		uint64_t focalLength = 0;
 
-		uint64_t hash() const { return lavaHash(label); }
+		constexpr uint64_t hash() const { return lavaHash(label); }
 	};
 
 	struct LensFocuser
@@ -37,26 +39,22 @@ namespace d15
 		std::vector<std::string> instructions;
 		std::vector<std::vector<Lens>> boxes;
 
-		explicit LensFocuser(const char* filename)
+		constexpr explicit LensFocuser(std::string_view input)
 		{
-			loadInstructions(filename);
+			loadInstructions(input);
 			fillBoxes();
 		}
 
-		void loadInstructions(const char* filename)
+		constexpr void loadInstructions(std::string_view input)
 		{
-			std::fstream s{ filename, s.in };
-			assert(s.is_open());
-
-			std::string line;
-			std::getline(s, line);
+			const std::string_view line = *aoc::lines(input).begin();
 			assert(line.size() > 0);
 
 			for (const auto word : std::views::split(line, ','))
 				instructions.emplace_back(&*word.begin(), std::ranges::distance(word));
 		}
 
-		void fillBoxes()
+		constexpr void fillBoxes()
 		{
 			boxes.resize(256);
 
@@ -76,10 +74,10 @@ namespace d15
 					assert(pos != std::string::npos);
 
 					const std::string label = instruction.substr(0, pos);
-					const std::string focalLengthStr = instruction.substr(pos + 1);
+					std::string_view focalLengthStr = std::string_view(instruction).substr(pos + 1);
 
 					const uint64_t hash = lavaHash(label);
-					const uint64_t focalLength = std::stoull(focalLengthStr);
+					const uint64_t focalLength = (uint64_t) aoc::consumeNumber(focalLengthStr);
 
 					auto& box = boxes[hash];
 
@@ -92,7 +90,7 @@ namespace d15
 			}
 		}
 
-		uint64_t calculateFocusingPower() const
+		constexpr uint64_t calculateFocusingPower() const
 		{
 			uint64_t power = 0;
 
@@ -108,7 +106,7 @@ namespace d15
 		}
 	};
 
-	static uint64_t partOne(const LensFocuser& f)
+	static constexpr uint64_t partOne(const LensFocuser& f)
 	{
 		return std::accumulate(
 			begin(f.instructions),
@@ -118,29 +116,39 @@ namespace d15
 		);
 	}
 
-	static uint64_t partTwo(const LensFocuser& f)
+	static constexpr uint64_t partTwo(const LensFocuser& f)
 	{
 		return f.calculateFocusingPower();
 	}
 
-	static std::pair<uint64_t, uint64_t> process(const char* filename)
+	static constexpr aoc::Answers<> process(std::string_view input)
 	{
-		const LensFocuser data(filename);
-		return std::make_pair(partOne(data), partTwo(data));
+		const LensFocuser data(input);
+		return { partOne(data), partTwo(data) };
 	}
 
+	// Copy of data/15/test.txt, checked at compile time.
+	static constexpr std::string_view testInput = "rn=1,cm-,qp=3,cm=2,qp-,pc=4,ot=9,ab=5,pc-,pc=6,ot=7";
+
+	static_assert(lavaHash("HASH") == 52);
+	static_assert(process(testInput) == aoc::Answers<>{ 1320, 145 });
+
 	static void processPrintAndAssert(const char* filename, std::pair<uint64_t, uint64_t> expected)
 	{
-		const auto result = process(filename);
-		std::cout << "Part 1: " << result.first << " Part 2: " << result.second << std::endl;
+		const auto result = aoc::solveDay15(aoc::readFile(filename));
+		std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
 
-		assert(expected.first == 0 || result.first == expected.first);
-		assert(expected.second == 0 || result.second == expected.second);
+		assert(expected.first == 0 || result.partOne == expected.first);
+		assert(expected.second == 0 || result.partTwo == expected.second);
 	}
 }
 
+aoc::Answers<> aoc::solveDay15(std::string_view input)
+{
+	return d15::process(input);
+}
+
 void day15()
 {
-	d15::processPrintAndAssert("../data/15/test.txt", std::make_pair(1320ull, 145ull));
 	d15::processPrintAndAssert("../data/15/real.txt", std::make_pair(503487ull, 0ull));
 }
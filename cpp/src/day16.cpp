@@ -1,6 +1,6 @@
 #include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <functional>
 #include <map>
@@ -9,69 +9,46 @@
 #include <ranges>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 #include <unordered_map>
 
+#include "aoc.h"
+#include "dispatch.h"
+#include "grid.h"
+#include "input.h"
+
 namespace d16
 {
-	struct Position
-	{
-		int x = -1;
-		int y = -1;
-
-		bool isValid() const { return x != -1 && y != -1; }
-
-		auto operator<=>(const Position&) const = default;
-
-		Position left()		const { assert(isValid()); return { x - 1, y }; }
-		Position right()	const { assert(isValid()); return { x + 1, y }; }
-		Position up()		const { assert(isValid()); return { x, y - 1 }; }
-		Position down()		const { assert(isValid()); return { x, y + 1 }; }
-	};
-
-	enum class Direction
-	{
-		Left,
-		Right,
-		Up,
-		Down
-	};
+	using aoc::Cell;
+	using aoc::Direction;
+	using aoc::NoCell;
 
 	struct Ray
 	{
-		Position pos;
+		Cell pos = NoCell;
 		Direction dir = Direction::Left;
-
-		auto operator<=>(const Ray&) const = default;
-
-		Ray goLeft() const	{ return { pos.left(), Direction::Left }; }
-		Ray goRight() const { return { pos.right(), Direction::Right}; }
-		Ray goUp() const	{ return { pos.up(), Direction::Up }; }
-		Ray goDown() const	{ return { pos.down(), Direction::Down}; }
 	};
 
 	struct Grid
 	{
-		std::vector<std::string> rows;
+		// Border cells hold a character that never appears in the input, marking the edge of the grid.
+		static constexpr char Border = ' ';
 
-		explicit Grid(const char* filename)
-		{
-			std::fstream s{ filename, s.in };
-			assert(s.is_open());
+		aoc::Grid<char> cells;
 
-			while (s.peek() != EOF)
-			{
-				std::string line;
-				std::getline(s, line);
-				assert(line.size() > 0);
-				rows.push_back(line);
-			}
+		explicit Grid(std::string_view input)
+			: cells(aoc::loadCharGrid(input, Border))
+		{
 		}
 
+		const aoc::GridLayout& layout() const { return cells.layout; }
+
 		uint64_t traverseAndCountVisited(const Ray& start) const
 		{
-			std::set<Ray> visitedRays;
-			std::set<Position> visitedPositions;
+			// One bit per direction a ray has passed through each cell in.
+			std::vector<uint8_t> visitedDirs(layout().numCells(), 0);
+			uint64_t numVisited = 0;
 
 			std::vector<Ray> queue;
 			queue.push_back(start);
@@ -81,10 +58,14 @@ namespace d16
 				Ray ray = queue.back();
 				queue.pop_back();
 
-				if (!visitedRays.insert(ray).second)
+				uint8_t& visited = visitedDirs[ray.pos];
+				const uint8_t dirBit = (uint8_t) (1 << (int) ray.dir);
+
+				if (visited & dirBit)
 					continue;
 
-				visitedPositions.insert(ray.pos);
+				numVisited += (visited == 0);
+				visited |= dirBit;
 
 				const std::pair<Ray, Ray> next = advance(ray);
 
@@ -95,75 +76,77 @@ namespace d16
 					queue.push_back(next.second);
 			}
 
-			return visitedPositions.size();
+			return numVisited;
+		}
+
+		bool isValidPos(Cell pos) const
+		{
+			return pos != NoCell
+				&& cells[pos] != Border;
 		}
 
-		bool isValidPos(const Position& pos) const
+		Ray go(const Ray& ray, Direction dir) const
 		{
-			return pos.isValid()
-				&& pos.x < (int) rows.front().size()
-				&& pos.y < (int) rows.size();
+			return { layout().step(ray.pos, dir), dir };
 		}
 
 		std::pair<Ray, Ray> advance(const Ray& ray) const
 		{
-			const char c = rows[ray.pos.y][ray.pos.x];
+			const char c = cells[ray.pos];
 
 			switch (c)
 			{
 				case '.':
 				{
-					switch (ray.dir)
-					{
-						case Direction::Up:		return { ray.goUp(), {} };
-						case Direction::Down:	return { ray.goDown(), {} };
-						case Direction::Left:	return { ray.goLeft(), {} };
-						case Direction::Right:	return { ray.goRight(), {} };
-					}
+					return { go(ray, ray.dir), {} };
 				}
 
 				case '/':
 				{
 					switch (ray.dir)
 					{
-						case Direction::Up:		return { ray.goRight(), {} };
-						case Direction::Down:	return { ray.goLeft(), {} };
-						case Direction::Left:	return { ray.goDown(), {} };
-						case Direction::Right:	return { ray.goUp(), {} };
+						case Direction::Up:		return { go(ray, Direction::Right), {} };
+						case Direction::Down:	return { go(ray, Direction::Left), {} };
+						case Direction::Left:	return { go(ray, Direction::Down), {} };
+						case Direction::Right:	return { go(ray, Direction::Up), {} };
 					}
+					break;
 				}
 
 				case '\\':
 				{
 					switch (ray.dir)
 					{
-						case Direction::Up:		return { ray.goLeft(), {} };
-						case Direction::Down:	return { ray.goRight(), {} };
-						case Direction::Left:	return { ray.goUp(), {} };
-						case Direction::Right:	return { ray.goDown(), {} };
+						case Direction::Up:		return { go(ray, Direction::Left), {} };
+						case Direction::Down:	return { go(ray, Direction::Right), {} };
+						case Direction::Left:	return { go(ray, Direction::Up), {} };
+						case Direction::Right:	return { go(ray, Direction::Down), {} };
 					}
+					break;
 				}
 
 				case '|':
 				{
 					switch (ray.dir)
 					{
-						case Direction::Up:		return { ray.goUp(), {} };
-						case Direction::Down:	return { ray.goDown(), {} };
-						case Direction::Left:	return { ray.goUp(), ray.goDown() }; 
-						case Direction::Right:	return { ray.goUp(), ray.goDown() };
+						case Direction::Up:		return { go(ray, Direction::Up), {} };
+						case Direction::Down:	return { go(ray, Direction::Down), {} };
+						case Direction::Left:	return { go(ray, Direction::Up), go(ray, Direction::Down) };
+						case Direction::Right:	return { go(ray, Direction::Up), go(ray, Direction::Down) };
 					}
+					break;
 				}
 
 				case '-':
 				{
 					switch (ray.dir)
 					{
-						case Direction::Up:		return { ray.goLeft(), ray.goRight() };
-						case Direction::Down:	return { ray.goLeft(), ray.goRight() };
-						case Direction::Left:	return { ray.goLeft(), {} }; 
-						case Direction::Right:	return { ray.goRight(), {} };
+						case Direction::Up:		return { go(ray, Direction::Left), go(ray, Direction::Right) };
+						case Direction::Down:	return { go(ray, Direction::Left), go(ray, Direction::Right) };
+						case Direction::Left:	return { go(ray, Direction::Left), {} };
+						case Direction::Right:	return { go(ray, Direction::Right), {} };
 					}
+					break;
 				}
 			}
 
@@ -171,48 +154,110 @@ namespace d16
 		}
 	};
 
-	static uint64_t partOne(const Grid& grid)
+	static uint64_t mostVisitedScalar(const Grid& grid, const std::vector<Ray>& starts, const aoc::SolveContext& context)
 	{
-		return grid.traverseAndCountVisited({{0, 0}, Direction::Right});
+		uint64_t mostVisited = 0;
+
+		for (size_t i = 0; i < starts.size(); ++i)
+		{
+			context.checkpoint("Edge starts", i, starts.size());
+			mostVisited = std::max(mostVisited, grid.traverseAndCountVisited(starts[i]));
+		}
+
+		return mostVisited;
 	}
 
-	static uint64_t partTwo(const Grid& grid)
+	static uint64_t mostVisitedParallel(const Grid& grid, const std::vector<Ray>& starts, const aoc::SolveContext& context)
 	{
-		// Brute forced, but fast enough.
+		const unsigned numThreads = aoc::cpuFeatures().hardwareThreads;
 
-		uint64_t mostVisited = 0;
-		
-		for (size_t x = 0; x < grid.rows.front().size(); ++x)
-			mostVisited = std::max(mostVisited, grid.traverseAndCountVisited({ {(int) x, 0}, Direction::Down }));
+		std::atomic<size_t> nextStart = 0;
+		std::vector<uint64_t> mostVisited(numThreads, 0);
 
-		for (size_t x = 0; x < grid.rows.front().size(); ++x)
-			mostVisited = std::max(mostVisited, grid.traverseAndCountVisited({ {(int) x, (int) grid.rows.size() - 1 }, Direction::Up }));
+		auto traverseStarts = [&] (unsigned thread)
+		{
+			for (size_t i = nextStart++; i < starts.size(); i = nextStart++)
+				mostVisited[thread] = std::max(mostVisited[thread], grid.traverseAndCountVisited(starts[i]));
+		};
 
-		for (size_t y = 0; y < grid.rows.size(); ++y)
-			mostVisited = std::max(mostVisited, grid.traverseAndCountVisited({ {0, (int) y}, Direction::Right }));
+		{
+			std::vector<std::jthread> workers;
 
-		for (size_t y = 0; y < grid.rows.size(); ++y)
-			mostVisited = std::max(mostVisited, grid.traverseAndCountVisited({ {(int) grid.rows.front().size() - 1, (int) y}, Direction::Left }));
+			for (unsigned thread = 1; thread < numThreads; ++thread)
+				workers.emplace_back(traverseStarts, thread);
 
-		return mostVisited;
+			// This thread takes its share of the starts too, and is the only one to call checkpoint(),
+			// which isn't thread safe. If cancelled, the workers are drained before unwinding.
+			try
+			{
+				for (size_t i = nextStart++; i < starts.size(); i = nextStart++)
+				{
+					context.checkpoint("Edge starts", i, starts.size());
+					mostVisited[0] = std::max(mostVisited[0], grid.traverseAndCountVisited(starts[i]));
+				}
+			}
+			catch (...)
+			{
+				nextStart = starts.size();
+				throw;
+			}
+		}
+
+		return *std::max_element(begin(mostVisited), end(mostVisited));
+	}
+
+	static const aoc::KernelSet<uint64_t(const Grid&, const std::vector<Ray>&, const aoc::SolveContext&)> mostVisitedKernels(16, "day16.edgeStarts",
+	{
+		{ { .name = "parallel", .multithreaded = true, .minInputSize = 64 }, &mostVisitedParallel },
+		{ { .name = "scalar" }, &mostVisitedScalar },
+	});
+
+	static uint64_t partOne(const Grid& grid)
+	{
+		return grid.traverseAndCountVisited({ grid.layout().cell(0, 0), Direction::Right });
 	}
 
-	static std::pair<uint64_t, uint64_t> process(const char* filename)
+	static uint64_t partTwo(const Grid& grid, const aoc::SolveContext& context)
 	{
-		const Grid grid(filename);
-		return std::make_pair(partOne(grid), partTwo(grid));
+		// Brute forced, but fast enough.
+
+		const aoc::GridLayout& layout = grid.layout();
+		const uint32_t width = layout.getWidth();
+		const uint32_t height = layout.getHeight();
+
+		std::vector<Ray> starts;
+		
+		for (uint32_t x = 0; x < width; ++x)
+			starts.push_back({ layout.cell(x, 0), Direction::Down });
+
+		for (uint32_t x = 0; x < width; ++x)
+			starts.push_back({ layout.cell(x, height - 1), Direction::Up });
+
+		for (uint32_t y = 0; y < height; ++y)
+			starts.push_back({ layout.cell(0, y), Direction::Right });
+
+		for (uint32_t y = 0; y < height; ++y)
+			starts.push_back({ layout.cell(width - 1, y), Direction::Left });
+
+		return mostVisitedKernels.select(starts.size())(grid, starts, context);
 	}
 
 	static void processPrintAndAssert(const char* filename, std::pair<uint64_t, uint64_t> expected)
 	{
-		const auto result = process(filename);
-		std::cout << "Part 1: " << result.first << " Part 2: " << result.second << std::endl;
+		const auto result = aoc::solveDay16(aoc::readFile(filename));
+		std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
 
-		assert(expected.first == 0 || result.first == expected.first);
-		assert(expected.second == 0 || result.second == expected.second);
+		assert(expected.first == 0 || result.partOne == expected.first);
+		assert(expected.second == 0 || result.partTwo == expected.second);
 	}
 }
 
+aoc::Answers<> aoc::solveDay16(std::string_view input, const SolveContext& context)
+{
+	const d16::Grid grid(input);
+	return { d16::partOne(grid), d16::partTwo(grid, context) };
+}
+
 void day16()
 {
 	d16::processPrintAndAssert("../data/16/test.txt", std::make_pair(46ull, 51ull));
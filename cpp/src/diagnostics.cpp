@@ -0,0 +1,111 @@
+#include "diagnostics.h"
+
+#include <cstdio>
+#include <iostream>
+
+static constexpr size_t FlushThreshold = 64 * 1024;
+
+static std::string_view toString(aoc::Verbosity level)
+{
+	switch (level)
+	{
+		case aoc::Verbosity::Quiet: return "quiet";
+		case aoc::Verbosity::Summary: return "summary";
+		case aoc::Verbosity::Detail: return "detail";
+	}
+
+	return "unknown";
+}
+
+void aoc::DiagnosticSink::setOutput(std::ostream& _output)
+{
+	std::lock_guard lock(mutex);
+	flushLocked();
+	output = &_output;
+}
+
+void aoc::DiagnosticSink::write(Verbosity level, std::string_view topic, std::string_view message)
+{
+	if (!isEnabled(level))
+		return;
+
+	std::lock_guard lock(mutex);
+
+	if (format == DiagnosticsFormat::Json)
+	{
+		buffer += "{\"level\":\"";
+		buffer += toString(level);
+		buffer += "\",\"topic\":\"";
+		buffer += jsonEscape(topic);
+		buffer += "\",\"message\":\"";
+		buffer += jsonEscape(message);
+		buffer += "\"}\n";
+	}
+	else
+	{
+		buffer += "[";
+		buffer += topic;
+		buffer += "] ";
+		buffer += message;
+		buffer += '\n';
+	}
+
+	if (buffer.size() >= FlushThreshold)
+		flushLocked();
+}
+
+void aoc::DiagnosticSink::flush()
+{
+	std::lock_guard lock(mutex);
+	flushLocked();
+}
+
+void aoc::DiagnosticSink::flushLocked()
+{
+	if (buffer.empty())
+		return;
+
+	std::ostream& out = output ? *output : std::cout;
+	out.write(buffer.data(), (std::streamsize) buffer.size());
+	out.flush();
+
+	buffer.clear();
+}
+
+aoc::DiagnosticSink& aoc::diagnostics()
+{
+	static DiagnosticSink sink;
+	return sink;
+}
+
+std::string aoc::jsonEscape(std::string_view text)
+{
+	std::string escaped;
+	escaped.reserve(text.size());
+
+	for (const char c : text)
+	{
+		switch (c)
+		{
+			case '"': escaped += "\\\""; break;
+			case '\\': escaped += "\\\\"; break;
+			case '\n': escaped += "\\n"; break;
+			case '\r': escaped += "\\r"; break;
+			case '\t': escaped += "\\t"; break;
+			default:
+				if ((unsigned char) c < 0x20)
+				{
+					char code[8];
+					std::snprintf(code, sizeof(code), "\\u%04x", (unsigned) c);
+					escaped += code;
+				}
+				else
+				{
+					escaped += c;
+				}
+				break;
+		}
+	}
+
+	return escaped;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace aoc
+{
+	enum class Verbosity : uint8_t
+	{
+		Quiet,   // nothing but the answers
+		Summary, // a few lines per solve, e.g. cycle lengths found
+		Detail   // per-item dumps, e.g. every ranked hand
+	};
+
+	enum class DiagnosticsFormat : uint8_t
+	{
+		Text,
+		Json // one object per line: {"level":..., "topic":..., "message":...}
+	};
+
+	// Sink for the solvers' diagnostic output, which is off (Quiet) by default.
+	// Records are buffered and only written out when the buffer fills or on flush(),
+	// so that console I/O never dominates a solver's runtime.
+	// Callers building expensive messages should check isEnabled() first.
+	class DiagnosticSink
+	{
+	public:
+		~DiagnosticSink() { flush(); }
+
+		void setVerbosity(Verbosity level) { verbosity = level; }
+		void setFormat(DiagnosticsFormat _format) { format = _format; }
+		void setOutput(std::ostream& _output);
+
+		bool isEnabled(Verbosity level) const { return level != Verbosity::Quiet && level <= verbosity.load(std::memory_order_relaxed); }
+
+		void write(Verbosity level, std::string_view topic, std::string_view message);
+		void flush();
+
+	private:
+		void flushLocked();
+
+		std::atomic<Verbosity> verbosity = Verbosity::Quiet;
+		DiagnosticsFormat format = DiagnosticsFormat::Text;
+		std::ostream* output = nullptr;
+
+		std::mutex mutex;
+		std::string buffer;
+	};
+
+	DiagnosticSink& diagnostics();
+
+	// Escapes a string for use inside a JSON string literal.
+	std::string jsonEscape(std::string_view text);
+}
@@ -0,0 +1,276 @@
+#include "dispatch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "diagnostics.h"
+
+#if defined(AOC_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(AOC_X86)
+#include <cpuid.h>
+#endif
+
+static constexpr int CalibrationRuns = 5;
+
+static std::atomic<bool> oneThreadOnly = false;
+
+#if defined(AOC_X86)
+static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4])
+{
+#if defined(_MSC_VER)
+	int r[4];
+	__cpuidex(r, (int) leaf, (int) subleaf);
+	std::copy(r, r + 4, regs);
+#else
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Which register states the OS saves on context switches; AVX is unusable unless it saves YMM.
+static uint64_t readXcr0()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	uint32_t eax = 0;
+	uint32_t edx = 0;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return ((uint64_t) edx << 32) | eax;
+#endif
+}
+#endif
+
+static aoc::CpuFeatures probeCpuFeatures()
+{
+	aoc::CpuFeatures features;
+	features.hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+#if defined(AOC_X86)
+	uint32_t regs[4] = {};
+
+	cpuid(0, 0, regs);
+	const uint32_t maxLeaf = regs[0];
+
+	if (maxLeaf < 1)
+		return features;
+
+	cpuid(1, 0, regs);
+	features.sse42 = (regs[2] & (1u << 20)) != 0;
+
+	const bool osSavesXmmYmm = (regs[2] & (1u << 27)) != 0 && (readXcr0() & 0x06) == 0x06;
+	const bool osSavesZmm = osSavesXmmYmm && (readXcr0() & 0xe0) == 0xe0;
+
+	if (maxLeaf < 7)
+		return features;
+
+	cpuid(0x80000000, 0, regs);
+	const uint32_t maxExtendedLeaf = regs[0];
+
+	bool hasLzcnt = false;
+	if (maxExtendedLeaf >= 0x80000001)
+	{
+		cpuid(0x80000001, 0, regs);
+		hasLzcnt = (regs[2] & (1u << 5)) != 0;
+	}
+
+	cpuid(7, 0, regs);
+	const bool hasBmi1 = (regs[1] & (1u << 3)) != 0;
+
+	features.avx2 = osSavesXmmYmm && (regs[1] & (1u << 5)) != 0 && hasBmi1 && hasLzcnt;
+	features.avx512 = osSavesZmm && (regs[1] & (1u << 16)) != 0 && (regs[1] & (1u << 30)) != 0;
+#endif
+
+	return features;
+}
+
+bool aoc::CpuFeatures::supports(Isa isa) const
+{
+	switch (isa)
+	{
+		case Isa::Scalar: return true;
+		case Isa::Sse42: return sse42;
+		case Isa::Avx2: return avx2;
+		case Isa::Avx512: return avx512;
+	}
+
+	return false;
+}
+
+const aoc::CpuFeatures& aoc::cpuFeatures()
+{
+	static const CpuFeatures features = probeCpuFeatures();
+	return features;
+}
+
+struct Tuning
+{
+	std::mutex mutex;
+	std::map<std::string, std::string, std::less<>> choices; // "<kernel> <size bucket>" -> variant name
+};
+
+static Tuning& tuning()
+{
+	static Tuning instance;
+	return instance;
+}
+
+static std::vector<aoc::Kernel*>& kernels()
+{
+	static std::vector<aoc::Kernel*> registered;
+	return registered;
+}
+
+// Inputs within a factor of two of each other share a choice of variant.
+static unsigned sizeBucket(size_t inputSize)
+{
+	return (unsigned) std::bit_width(inputSize);
+}
+
+static std::string choiceKey(std::string_view kernel, unsigned bucket)
+{
+	return std::string(kernel) + " " + std::to_string(bucket);
+}
+
+aoc::Kernel::Kernel(int _day, std::string_view _name, std::vector<VariantInfo> _variants)
+	: day(_day)
+	, name(_name)
+	, variants(std::move(_variants))
+{
+	assert(name.find(' ') == std::string_view::npos);
+	kernels().push_back(this);
+}
+
+bool aoc::Kernel::isSupported(size_t variant) const
+{
+	const VariantInfo& info = variants[variant];
+	return cpuFeatures().supports(info.isa)
+		&& (!info.multithreaded || (cpuFeatures().hardwareThreads > 1 && !oneThreadOnly.load(std::memory_order_relaxed)));
+}
+
+void aoc::restrictToOneThread()
+{
+	oneThreadOnly.store(true, std::memory_order_relaxed);
+}
+
+size_t aoc::Kernel::selectVariant(size_t inputSize) const
+{
+	lastInputSize = inputSize;
+
+	const int forced = forcedVariant;
+	if (forced >= 0)
+		return (size_t) forced;
+
+	{
+		Tuning& t = tuning();
+		std::lock_guard lock(t.mutex);
+
+		const auto iter = t.choices.find(choiceKey(name, sizeBucket(inputSize)));
+		if (iter != end(t.choices))
+			for (size_t i = 0; i < variants.size(); ++i)
+				if (variants[i].name == iter->second && isSupported(i))
+					return i;
+	}
+
+	for (size_t i = 0; i < variants.size(); ++i)
+		if (isSupported(i) && inputSize >= variants[i].minInputSize)
+			return i;
+
+	return variants.size() - 1;
+}
+
+void aoc::calibrate(int day, const std::function<void()>& solve)
+{
+	for (Kernel* kernel : kernels())
+	{
+		if (kernel->day != day)
+			continue;
+
+		kernel->lastInputSize = 0;
+
+		size_t fastestVariant = kernel->variants.size() - 1;
+		double fastestTime = std::numeric_limits<double>::max();
+		std::string report = std::string(kernel->name) + ":";
+
+		for (size_t i = 0; i < kernel->variants.size(); ++i)
+		{
+			if (!kernel->isSupported(i))
+				continue;
+
+			kernel->forcedVariant = (int) i;
+
+			double bestRun = std::numeric_limits<double>::max();
+
+			for (int run = 0; run < CalibrationRuns; ++run)
+			{
+				const auto start = std::chrono::steady_clock::now();
+				solve();
+				bestRun = std::min(bestRun, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+			}
+
+			report += " " + std::string(kernel->variants[i].name) + " " + std::to_string(bestRun * 1000.0) + "ms";
+
+			if (bestRun < fastestTime)
+			{
+				fastestTime = bestRun;
+				fastestVariant = i;
+			}
+		}
+
+		kernel->forcedVariant = -1;
+
+		// The kernel wasn't used for this input, so there's nothing to learn.
+		if (kernel->lastInputSize == 0)
+			continue;
+
+		{
+			Tuning& t = tuning();
+			std::lock_guard lock(t.mutex);
+			t.choices[choiceKey(kernel->name, sizeBucket(kernel->lastInputSize))] = std::string(kernel->variants[fastestVariant].name);
+		}
+
+		report += " -> " + std::string(kernel->variants[fastestVariant].name);
+		diagnostics().write(Verbosity::Summary, "dispatch", report);
+	}
+}
+
+bool aoc::loadTuning(const char* filename)
+{
+	std::ifstream file(filename);
+	if (!file)
+		return false;
+
+	Tuning& t = tuning();
+	std::lock_guard lock(t.mutex);
+
+	std::string kernel;
+	unsigned bucket = 0;
+	std::string variant;
+
+	while (file >> kernel >> bucket >> variant)
+		t.choices[choiceKey(kernel, bucket)] = variant;
+
+	return true;
+}
+
+bool aoc::saveTuning(const char* filename)
+{
+	std::ofstream file(filename);
+	if (!file)
+		return false;
+
+	Tuning& t = tuning();
+	std::lock_guard lock(t.mutex);
+
+	for (const auto& [key, variant] : t.choices)
+		file << key << ' ' << variant << '\n';
+
+	return (bool) file;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Runtime selection between a solver's implementations (scalar, SIMD, multithreaded, ...).
+//
+// Each kernel lists its variants best first. By default the first variant this CPU supports
+// and whose minimum input size is met is used. calibrate() instead times every supported
+// variant on a real input and records the fastest for that size of input, and those choices
+// can be saved to and loaded from a tuning file so that each host only calibrates once.
+
+#if (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))) || defined(__x86_64__) || defined(__i386__)
+#define AOC_X86 1
+#endif
+
+// Marks functions using AVX2 intrinsics, which GCC and Clang otherwise only allow when the whole
+// file is built for AVX2. They must only be called when cpuFeatures().supports(Isa::Avx2).
+#if defined(__GNUC__) || defined(__clang__)
+#define AOC_TARGET_AVX2 __attribute__((target("avx2,bmi,lzcnt")))
+#else
+#define AOC_TARGET_AVX2
+#endif
+
+namespace aoc
+{
+	enum class Isa : uint8_t
+	{
+		Scalar,
+		Sse42,
+		Avx2,  // along with the BMI1 and LZCNT bit instructions that ship with it
+		Avx512 // F and BW
+	};
+
+	struct CpuFeatures
+	{
+		bool sse42 = false;
+		bool avx2 = false;
+		bool avx512 = false;
+		unsigned hardwareThreads = 1;
+
+		bool supports(Isa isa) const;
+	};
+
+	// Probed once, on first use.
+	const CpuFeatures& cpuFeatures();
+
+	// Stops multithreaded variants being selected in this process, e.g., in a worker process that's
+	// already one of several solving an input side by side.
+	void restrictToOneThread();
+
+	struct VariantInfo
+	{
+		std::string_view name;
+		Isa isa = Isa::Scalar;
+		bool multithreaded = false;
+		size_t minInputSize = 0; // below this, the variant's setup costs outweigh its gains
+	};
+
+	// Type independent part of KernelSet. Kernels register themselves on construction,
+	// so must have static storage duration.
+	class Kernel
+	{
+	public:
+		Kernel(int day, std::string_view name, std::vector<VariantInfo> variants);
+		Kernel(const Kernel&) = delete;
+		Kernel& operator=(const Kernel&) = delete;
+
+		int getDay() const { return day; }
+		std::string_view getName() const { return name; }
+		const std::vector<VariantInfo>& getVariants() const { return variants; }
+
+		bool isSupported(size_t variant) const;
+
+		// Index of the variant to use for an input of the given size.
+		size_t selectVariant(size_t inputSize) const;
+
+	private:
+		friend void calibrate(int day, const std::function<void()>& solve);
+
+		int day;
+		std::string_view name;
+		std::vector<VariantInfo> variants;
+
+		// Only set by calibrate(), which must not run alongside other solves.
+		int forcedVariant = -1;
+
+		// Input size most recently seen by selectVariant(), used to file calibration results.
+		mutable std::atomic<size_t> lastInputSize = 0;
+	};
+
+	// A kernel's variants, all sharing the signature Fn.
+	template <typename Fn>
+	class KernelSet : public Kernel
+	{
+	public:
+		using Variant = std::pair<VariantInfo, Fn*>;
+
+		KernelSet(int day, std::string_view name, std::initializer_list<Variant> _variants)
+			: Kernel(day, name, infosOf(_variants))
+		{
+			for (const Variant& variant : _variants)
+				functions.push_back(variant.second);
+		}
+
+		Fn* select(size_t inputSize) const
+		{
+			return functions[selectVariant(inputSize)];
+		}
+
+	private:
+		static std::vector<VariantInfo> infosOf(std::initializer_list<Variant> _variants)
+		{
+			std::vector<VariantInfo> infos;
+
+			for (const Variant& variant : _variants)
+				infos.push_back(variant.first);
+
+			assert(!infos.empty() && infos.back().isa == Isa::Scalar && !infos.back().multithreaded);
+
+			return infos;
+		}
+
+		std::vector<Fn*> functions;
+	};
+
+	// Runs solve() with each supported variant of each kernel registered for the day,
+	// and records the fastest variant for the size of input solve() works on.
+	void calibrate(int day, const std::function<void()>& solve);
+
+	// Tuning files hold one "<kernel> <size bucket> <variant>" choice per line.
+	bool loadTuning(const char* filename);
+	bool saveTuning(const char* filename);
+}
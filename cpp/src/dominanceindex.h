@@ -0,0 +1,260 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace aoc
+{
+	struct DominanceTotals
+	{
+		uint64_t count = 0;
+		uint64_t weightSum = 0;
+
+		constexpr bool operator==(const DominanceTotals&) const = default;
+	};
+
+	// Counts, and sums the weights of, the points dominated by a query point, i.e., no greater than it
+	// on any axis, without visiting the points.
+	//
+	// Each axis is compressed to the distinct coordinates the points use, and the points' totals are
+	// accumulated over the resulting grid of cells into a summed volume table. A query is then a binary
+	// search per axis and a single lookup, however many points there are.
+	//
+	// The table has a cell per combination of distinct coordinates. Where that would exceed maxCells,
+	// the points are instead kept in a k-d tree, whose nodes hold the bounding box and totals of their
+	// subtrees. Queries take whole subtrees inside the bound and skip those outside it, only descending
+	// into those straddling its faces, and the tree's memory only grows with the number of points.
+	template <size_t Dimensions>
+	class DominanceIndex
+	{
+	public:
+		using Point = std::array<uint64_t, Dimensions>;
+
+		static constexpr size_t MaxCells = size_t(1) << 20;
+
+		constexpr DominanceIndex(std::span<const Point> points, std::span<const uint64_t> weights, size_t maxCells = MaxCells)
+		{
+			assert(points.size() == weights.size());
+
+			size_t numCells = 1;
+
+			for (size_t axis = 0; axis < Dimensions; ++axis)
+			{
+				std::vector<uint64_t>& coordinates = axes[axis];
+
+				for (const Point& point : points)
+					coordinates.push_back(point[axis]);
+
+				std::sort(begin(coordinates), end(coordinates));
+				coordinates.erase(std::unique(begin(coordinates), end(coordinates)), end(coordinates));
+
+				numCells = std::min(numCells * coordinates.size(), maxCells + 1); // saturating, so it can't overflow
+			}
+
+			if (points.empty())
+				return;
+
+			if (numCells > maxCells)
+			{
+				buildTree(points, weights);
+				return;
+			}
+
+			cells.resize(numCells);
+
+			for (size_t i = 0; i < points.size(); ++i)
+			{
+				DominanceTotals& cell = cells[cellIndexOf(points[i])];
+				cell.count += 1;
+				cell.weightSum += weights[i];
+			}
+
+			// Prefix sums along each axis in turn leave each cell holding the totals of every cell it dominates.
+			size_t stride = 1;
+
+			for (size_t axis = 0; axis < Dimensions; ++axis)
+			{
+				const size_t axisSize = axes[axis].size();
+
+				for (size_t cell = 0; cell < numCells; ++cell)
+				{
+					if ((cell / stride) % axisSize == 0)
+						continue;
+
+					cells[cell].count += cells[cell - stride].count;
+					cells[cell].weightSum += cells[cell - stride].weightSum;
+				}
+
+				stride *= axisSize;
+			}
+		}
+
+		constexpr DominanceTotals query(const Point& bound) const
+		{
+			if (!nodes.empty())
+				return queryTree(bound, 0, nodes.size());
+
+			if (cells.empty())
+				return {};
+
+			size_t cell = 0;
+			size_t stride = 1;
+
+			for (size_t axis = 0; axis < Dimensions; ++axis)
+			{
+				const std::vector<uint64_t>& coordinates = axes[axis];
+
+				// The greatest coordinate in use that's within the bound.
+				const size_t upper = (size_t) (std::upper_bound(begin(coordinates), end(coordinates), bound[axis]) - begin(coordinates));
+				if (upper == 0)
+					return {};
+
+				cell += (upper - 1) * stride;
+				stride *= coordinates.size();
+			}
+
+			return cells[cell];
+		}
+
+	private:
+		struct Node
+		{
+			Point point = {};
+			DominanceTotals totals; // of the points merged into this node
+
+			Point boxMin = {};
+			Point boxMax = {};
+			DominanceTotals subtreeTotals;
+		};
+
+		static constexpr bool isDominated(const Point& point, const Point& bound)
+		{
+			bool dominated = true;
+
+			for (size_t axis = 0; axis < Dimensions; ++axis)
+				dominated = dominated && point[axis] <= bound[axis];
+
+			return dominated;
+		}
+
+		static constexpr void add(DominanceTotals& totals, const DominanceTotals& more)
+		{
+			totals.count += more.count;
+			totals.weightSum += more.weightSum;
+		}
+
+		// The tree is implicit in the order of the nodes: the root of a range of them is at its middle,
+		// and the halves either side of it are its subtrees.
+		static constexpr size_t rootOf(size_t first, size_t last) { return first + ((last - first) / 2); }
+
+		constexpr size_t cellIndexOf(const Point& point) const
+		{
+			size_t cell = 0;
+			size_t stride = 1;
+
+			for (size_t axis = 0; axis < Dimensions; ++axis)
+			{
+				const std::vector<uint64_t>& coordinates = axes[axis];
+
+				cell += (size_t) (std::lower_bound(begin(coordinates), end(coordinates), point[axis]) - begin(coordinates)) * stride;
+				stride *= coordinates.size();
+			}
+
+			return cell;
+		}
+
+		constexpr void buildTree(std::span<const Point> points, std::span<const uint64_t> weights)
+		{
+			for (size_t i = 0; i < points.size(); ++i)
+				nodes.push_back({ points[i], { 1, weights[i] }, points[i], points[i], {} });
+
+			// Coincident points are merged into one node.
+			std::sort(begin(nodes), end(nodes), [] (const Node& a, const Node& b) { return a.point < b.point; });
+
+			size_t numNodes = 0;
+
+			for (size_t i = 0; i < nodes.size(); ++i)
+			{
+				if (numNodes > 0 && nodes[numNodes - 1].point == nodes[i].point)
+					add(nodes[numNodes - 1].totals, nodes[i].totals);
+				else
+					nodes[numNodes++] = nodes[i];
+			}
+
+			nodes.resize(numNodes);
+
+			splitNodes(0, nodes.size(), 0);
+		}
+
+		// Splits the range at the median on the axis, cycling through the axes with depth.
+		constexpr void splitNodes(size_t first, size_t last, size_t axis)
+		{
+			if (first >= last)
+				return;
+
+			const size_t root = rootOf(first, last);
+
+			std::nth_element(begin(nodes) + (ptrdiff_t) first, begin(nodes) + (ptrdiff_t) root, begin(nodes) + (ptrdiff_t) last,
+				[axis] (const Node& a, const Node& b) { return a.point[axis] < b.point[axis]; });
+
+			splitNodes(first, root, (axis + 1) % Dimensions);
+			splitNodes(root + 1, last, (axis + 1) % Dimensions);
+
+			Node& node = nodes[root];
+			node.boxMin = node.point;
+			node.boxMax = node.point;
+			node.subtreeTotals = node.totals;
+
+			for (const auto& [childFirst, childLast] : { std::pair(first, root), std::pair(root + 1, last) })
+			{
+				if (childFirst >= childLast)
+					continue;
+
+				const Node& child = nodes[rootOf(childFirst, childLast)];
+
+				for (size_t i = 0; i < Dimensions; ++i)
+				{
+					node.boxMin[i] = std::min(node.boxMin[i], child.boxMin[i]);
+					node.boxMax[i] = std::max(node.boxMax[i], child.boxMax[i]);
+				}
+
+				add(node.subtreeTotals, child.subtreeTotals);
+			}
+		}
+
+		constexpr DominanceTotals queryTree(const Point& bound, size_t first, size_t last) const
+		{
+			if (first >= last)
+				return {};
+
+			const size_t root = rootOf(first, last);
+			const Node& node = nodes[root];
+
+			if (!isDominated(node.boxMin, bound))
+				return {};
+
+			if (isDominated(node.boxMax, bound))
+				return node.subtreeTotals;
+
+			DominanceTotals totals = queryTree(bound, first, root);
+			add(totals, queryTree(bound, root + 1, last));
+
+			if (isDominated(node.point, bound))
+				add(totals, node.totals);
+
+			return totals;
+		}
+
+		std::array<std::vector<uint64_t>, Dimensions> axes;
+		std::vector<DominanceTotals> cells; // [sum of axis index * stride], first axis varying fastest
+
+		// Only built when the table would be too large.
+		std::vector<Node> nodes;
+	};
+}
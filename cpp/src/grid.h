@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+#include "input.h"
+
+namespace aoc
+{
+	// A cell in a grid, stored as a 32-bit index into the grid's row-major buffer.
+	// Grids are surrounded by a one cell border, so stepping in any direction from a cell
+	// inside the grid is a single add of a precomputed stride and never needs a bounds check.
+	using Cell = uint32_t;
+
+	// The top-left border corner is never inside a grid nor next to a cell that is,
+	// so index 0 doubles as "no cell".
+	constexpr Cell NoCell = 0;
+
+	enum class Direction : uint8_t
+	{
+		Left,
+		Right,
+		Up,
+		Down
+	};
+
+	class GridLayout
+	{
+	public:
+		GridLayout() = default;
+
+		GridLayout(uint32_t _width, uint32_t _height)
+			: width(_width)
+			, height(_height)
+			, stride(_width + 2)
+			, steps{ -1, 1, -(int32_t) stride, (int32_t) stride }
+		{
+		}
+
+		uint32_t getWidth() const { return width; }
+		uint32_t getHeight() const { return height; }
+		uint32_t getStride() const { return stride; }
+
+		// Number of cells including the border.
+		uint32_t numCells() const { return stride * (height + 2); }
+
+		Cell cell(uint32_t x, uint32_t y) const
+		{
+			assert(x < width && y < height);
+			return ((y + 1) * stride) + (x + 1);
+		}
+
+		uint32_t x(Cell c) const { return (c % stride) - 1; }
+		uint32_t y(Cell c) const { return (c / stride) - 1; }
+
+		bool isInside(Cell c) const { return x(c) < width && y(c) < height; }
+
+		Cell step(Cell c, Direction dir) const { return c + steps[(size_t) dir]; }
+
+		Cell left(Cell c)  const { return c - 1; }
+		Cell right(Cell c) const { return c + 1; }
+		Cell up(Cell c)    const { return c - stride; }
+		Cell down(Cell c)  const { return c + stride; }
+
+		int64_t manhattanDistance(Cell lhs, Cell rhs) const
+		{
+			return std::abs((int64_t) x(lhs) - (int64_t) x(rhs))
+				+ std::abs((int64_t) y(lhs) - (int64_t) y(rhs));
+		}
+
+	private:
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t stride = 0;
+		std::array<int32_t, 4> steps = {};
+	};
+
+	template <typename T>
+	struct Grid
+	{
+		GridLayout layout;
+		std::vector<T> cells;
+
+		Grid() = default;
+
+		explicit Grid(const GridLayout& _layout, const T& fill = T())
+			: layout(_layout)
+			, cells(_layout.numCells(), fill)
+		{
+		}
+
+		T& operator[](Cell c) { return cells[c]; }
+		const T& operator[](Cell c) const { return cells[c]; }
+	};
+
+	// Loads a rectangular grid of characters, with the border cells set to the given character.
+	inline Grid<char> loadCharGrid(std::string_view input, char border)
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+
+		for (const std::string_view line : lines(input))
+		{
+			assert(line.size() > 0);
+			assert(width == 0 || line.size() == width);
+			width = (uint32_t) line.size();
+			++height;
+		}
+
+		Grid<char> grid(GridLayout(width, height), border);
+
+		uint32_t y = 0;
+		for (const std::string_view line : lines(input))
+		{
+			std::copy(begin(line), end(line), begin(grid.cells) + grid.layout.cell(0, y));
+			++y;
+		}
+
+		return grid;
+	}
+}
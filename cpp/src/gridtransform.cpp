@@ -0,0 +1,125 @@
+#include "gridtransform.h"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AOC_SSE2 1
+#endif
+
+// Blocks of this many rows and columns of source and destination fit comfortably in L1 together.
+static constexpr size_t BlockSize = 64;
+static constexpr size_t TileSize = 8;
+
+static void transposeTileScalar(const char* src, ptrdiff_t srcStride, char* dst, ptrdiff_t dstStride, size_t width, size_t height)
+{
+	for (size_t y = 0; y < height; ++y)
+		for (size_t x = 0; x < width; ++x)
+			dst[(ptrdiff_t) x * dstStride + (ptrdiff_t) y] = src[(ptrdiff_t) y * srcStride + (ptrdiff_t) x];
+}
+
+#if defined(AOC_SSE2)
+static void transposeTile8x8(const char* src, ptrdiff_t srcStride, char* dst, ptrdiff_t dstStride)
+{
+	const __m128i r0 = _mm_loadl_epi64((const __m128i*) (src + 0 * srcStride));
+	const __m128i r1 = _mm_loadl_epi64((const __m128i*) (src + 1 * srcStride));
+	const __m128i r2 = _mm_loadl_epi64((const __m128i*) (src + 2 * srcStride));
+	const __m128i r3 = _mm_loadl_epi64((const __m128i*) (src + 3 * srcStride));
+	const __m128i r4 = _mm_loadl_epi64((const __m128i*) (src + 4 * srcStride));
+	const __m128i r5 = _mm_loadl_epi64((const __m128i*) (src + 5 * srcStride));
+	const __m128i r6 = _mm_loadl_epi64((const __m128i*) (src + 6 * srcStride));
+	const __m128i r7 = _mm_loadl_epi64((const __m128i*) (src + 7 * srcStride));
+
+	// Interleave bytes of row pairs, then 2 byte pairs of those, then 4 byte quads,
+	// leaving each 8 byte half holding one column.
+	const __m128i rows01 = _mm_unpacklo_epi8(r0, r1);
+	const __m128i rows23 = _mm_unpacklo_epi8(r2, r3);
+	const __m128i rows45 = _mm_unpacklo_epi8(r4, r5);
+	const __m128i rows67 = _mm_unpacklo_epi8(r6, r7);
+
+	const __m128i rows0123Cols0123 = _mm_unpacklo_epi16(rows01, rows23);
+	const __m128i rows0123Cols4567 = _mm_unpackhi_epi16(rows01, rows23);
+	const __m128i rows4567Cols0123 = _mm_unpacklo_epi16(rows45, rows67);
+	const __m128i rows4567Cols4567 = _mm_unpackhi_epi16(rows45, rows67);
+
+	const __m128i cols01 = _mm_unpacklo_epi32(rows0123Cols0123, rows4567Cols0123);
+	const __m128i cols23 = _mm_unpackhi_epi32(rows0123Cols0123, rows4567Cols0123);
+	const __m128i cols45 = _mm_unpacklo_epi32(rows0123Cols4567, rows4567Cols4567);
+	const __m128i cols67 = _mm_unpackhi_epi32(rows0123Cols4567, rows4567Cols4567);
+
+	_mm_storel_epi64((__m128i*) (dst + 0 * dstStride), cols01);
+	_mm_storel_epi64((__m128i*) (dst + 1 * dstStride), _mm_unpackhi_epi64(cols01, cols01));
+	_mm_storel_epi64((__m128i*) (dst + 2 * dstStride), cols23);
+	_mm_storel_epi64((__m128i*) (dst + 3 * dstStride), _mm_unpackhi_epi64(cols23, cols23));
+	_mm_storel_epi64((__m128i*) (dst + 4 * dstStride), cols45);
+	_mm_storel_epi64((__m128i*) (dst + 5 * dstStride), _mm_unpackhi_epi64(cols45, cols45));
+	_mm_storel_epi64((__m128i*) (dst + 6 * dstStride), cols67);
+	_mm_storel_epi64((__m128i*) (dst + 7 * dstStride), _mm_unpackhi_epi64(cols67, cols67));
+}
+#endif
+
+static void transposeBlock(const char* src, ptrdiff_t srcStride, char* dst, ptrdiff_t dstStride, size_t width, size_t height)
+{
+#if defined(AOC_SSE2)
+	const size_t fullWidth = width - (width % TileSize);
+	const size_t fullHeight = height - (height % TileSize);
+
+	for (size_t y = 0; y < fullHeight; y += TileSize)
+		for (size_t x = 0; x < fullWidth; x += TileSize)
+			transposeTile8x8(src + (ptrdiff_t) y * srcStride + (ptrdiff_t) x, srcStride, dst + (ptrdiff_t) x * dstStride + (ptrdiff_t) y, dstStride);
+
+	// Ragged right and bottom edges.
+	transposeTileScalar(src + (ptrdiff_t) fullWidth, srcStride, dst + (ptrdiff_t) fullWidth * dstStride, dstStride, width - fullWidth, fullHeight);
+	transposeTileScalar(src + (ptrdiff_t) fullHeight * srcStride, srcStride, dst + (ptrdiff_t) fullHeight, dstStride, width, height - fullHeight);
+#else
+	transposeTileScalar(src, srcStride, dst, dstStride, width, height);
+#endif
+}
+
+void aoc::transpose(const ConstByteGrid& src, const ByteGrid& dst)
+{
+	assert(dst.width == src.height && dst.height == src.width);
+
+	for (size_t y = 0; y < src.height; y += BlockSize)
+	{
+		const size_t blockHeight = std::min(BlockSize, src.height - y);
+
+		for (size_t x = 0; x < src.width; x += BlockSize)
+		{
+			const size_t blockWidth = std::min(BlockSize, src.width - x);
+
+			transposeBlock(
+				src.data + (ptrdiff_t) y * src.stride + (ptrdiff_t) x, src.stride,
+				dst.data + (ptrdiff_t) x * dst.stride + (ptrdiff_t) y, dst.stride,
+				blockWidth, blockHeight);
+		}
+	}
+}
+
+// A clockwise rotation is a transpose of the source read bottom row first.
+void aoc::rotateClockwise(const ConstByteGrid& src, const ByteGrid& dst)
+{
+	if (src.height == 0)
+		return;
+
+	const ConstByteGrid flipped = { src.data + (ptrdiff_t) (src.height - 1) * src.stride, src.width, src.height, -src.stride };
+	transpose(flipped, dst);
+}
+
+// An anticlockwise rotation is a transpose written bottom row first.
+void aoc::rotateAnticlockwise(const ConstByteGrid& src, const ByteGrid& dst)
+{
+	if (dst.height == 0)
+		return;
+
+	const ByteGrid flipped = { dst.data + (ptrdiff_t) (dst.height - 1) * dst.stride, dst.width, dst.height, -dst.stride };
+	transpose(src, flipped);
+}
+
+void aoc::transposeNaive(const ConstByteGrid& src, const ByteGrid& dst)
+{
+	assert(dst.width == src.height && dst.height == src.width);
+
+	transposeTileScalar(src.data, src.stride, dst.data, dst.stride, src.width, src.height);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+
+// Transpose and rotate kernels for flat, row-major byte grids.
+//
+// Rather than copying one element at a time with a stride on one side, which touches a new
+// cache line per element once grids outgrow the cache, these work through the grid in blocks
+// small enough for both source and destination to stay in cache, using SSE2 for 8x8 tiles
+// where available. Grids need not be square.
+
+namespace aoc
+{
+	// Byte (x, y) is at data[y * stride + x]. Strides may be negative, to walk rows bottom up.
+	struct ConstByteGrid
+	{
+		const char* data = nullptr;
+		size_t width = 0;
+		size_t height = 0;
+		ptrdiff_t stride = 0;
+	};
+
+	struct ByteGrid
+	{
+		char* data = nullptr;
+		size_t width = 0;
+		size_t height = 0;
+		ptrdiff_t stride = 0;
+
+		operator ConstByteGrid() const { return { data, width, height, stride }; }
+	};
+
+	// In each, dst must be src.height wide and src.width high, and must not overlap src.
+
+	// dst(y, x) = src(x, y)
+	void transpose(const ConstByteGrid& src, const ByteGrid& dst);
+
+	// Rotates a quarter turn clockwise, so the bottom left of src becomes the top left of dst.
+	void rotateClockwise(const ConstByteGrid& src, const ByteGrid& dst);
+
+	// Rotates a quarter turn anticlockwise, so the top right of src becomes the top left of dst.
+	void rotateAnticlockwise(const ConstByteGrid& src, const ByteGrid& dst);
+
+	// Element by element transpose, as a reference for the blocked kernels.
+	void transposeNaive(const ConstByteGrid& src, const ByteGrid& dst);
+}
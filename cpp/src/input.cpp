@@ -0,0 +1,15 @@
+#include "input.h"
+
+#include <cassert>
+#include <fstream>
+#include <sstream>
+
+std::string aoc::readFile(const char* filename)
+{
+	std::fstream s{ filename, s.in | s.binary };
+	assert(s.is_open());
+
+	std::stringstream buffer;
+	buffer << s.rdbuf();
+	return buffer.str();
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+namespace aoc
+{
+	std::string readFile(const char* filename);
+
+	// Iterates the lines of an in-memory input the same way the getline loops did:
+	// a trailing newline does not produce a final empty line, and carriage returns are stripped.
+	class Lines
+	{
+	public:
+		class Iterator
+		{
+		public:
+			using value_type = std::string_view;
+			using difference_type = std::ptrdiff_t;
+
+			constexpr Iterator() = default;
+
+			constexpr explicit Iterator(std::string_view input)
+				: remaining(input)
+			{
+				advance();
+			}
+
+			constexpr std::string_view operator*() const { return line; }
+
+			constexpr Iterator& operator++()
+			{
+				advance();
+				return *this;
+			}
+
+			constexpr Iterator operator++(int)
+			{
+				Iterator prev = *this;
+				advance();
+				return prev;
+			}
+
+			constexpr bool operator==(std::default_sentinel_t) const { return done; }
+
+		private:
+			constexpr void advance()
+			{
+				if (remaining.empty())
+				{
+					done = true;
+					return;
+				}
+
+				const size_t end = remaining.find('\n');
+				line = remaining.substr(0, end);
+				remaining = end != std::string_view::npos ? remaining.substr(end + 1) : std::string_view();
+
+				if (!line.empty() && line.back() == '\r')
+					line.remove_suffix(1);
+			}
+
+			std::string_view remaining;
+			std::string_view line;
+			bool done = false;
+		};
+
+		constexpr explicit Lines(std::string_view _input) : input(_input) {}
+
+		constexpr Iterator begin() const { return Iterator(input); }
+		constexpr std::default_sentinel_t end() const { return {}; }
+
+	private:
+		std::string_view input;
+	};
+
+	constexpr Lines lines(std::string_view input) { return Lines(input); }
+
+	constexpr bool isDigit(char c) { return '0' <= c && c <= '9'; }
+
+	// Advances str to the start of the next (possibly negative) number.
+	// Returns false if there are no more numbers in str.
+	constexpr bool skipToNumber(std::string_view& str)
+	{
+		while (!str.empty())
+		{
+			if (isDigit(str.front()))
+				return true;
+
+			if (str.front() == '-' && str.size() > 1 && isDigit(str[1]))
+				return true;
+
+			str.remove_prefix(1);
+		}
+
+		return false;
+	}
+
+	// Parses the (possibly negative) number at the start of str, and advances str past it.
+	constexpr int64_t consumeNumber(std::string_view& str)
+	{
+		const bool negative = !str.empty() && str.front() == '-';
+		if (negative)
+			str.remove_prefix(1);
+
+		int64_t number = 0;
+
+		while (!str.empty() && isDigit(str.front()))
+		{
+			number = (number * 10) + (str.front() - '0');
+			str.remove_prefix(1);
+		}
+
+		return negative ? -number : number;
+	}
+}
@@ -1,9 +1,269 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "benchmarks.h"
+#include "diagnostics.h"
+#include "dispatch.h"
+#include "input.h"
+#include "prefetch.h"
+#include "runner.h"
+#include "shard.h"
+
 #define currentday day16
 
-int main()
+static constexpr const char* DefaultTuningFile = "aoc_tuning.txt";
+
+static void printUsage()
+{
+	std::fprintf(stderr, "Usage: AdventOfCode2023 [-v|-vv] [--json] [--budget <seconds>] [--calibrate] [--tuning <file>] [--shards <n>] [--bench] [--check-prefetch] [<day> <input file> ...]\n");
+	std::fprintf(stderr, "With no day/input pairs, runs the checks for the current day.\n");
+	std::fprintf(stderr, "  -v, -vv      Write summary or detailed diagnostics from the solvers\n");
+	std::fprintf(stderr, "  --json       Write results and diagnostics as JSON lines\n");
+	std::fprintf(stderr, "  --calibrate  Time each solver variant on the inputs and save the fastest to the tuning file\n");
+	std::fprintf(stderr, "  --tuning     Tuning file to load and save solver variant choices (default %s)\n", DefaultTuningFile);
+	std::fprintf(stderr, "  --shards     Split inputs for days 01, 02, 09 and 12 across this many worker processes\n");
+	std::fprintf(stderr, "  --bench      Benchmark the shared kernels before solving anything\n");
+	std::fprintf(stderr, "  --check-prefetch  Check that input prefetching recovers from failed reads\n");
+}
+
+struct CommandLine
+{
+	aoc::RunOptions options;
+	bool json = false;
+	bool calibrate = false;
+	unsigned shards = 0;
+	bool benchmark = false;
+	bool checkPrefetch = false;
+	const char* tuningFile = DefaultTuningFile;
+	int firstJob = 1;
+};
+
+static bool parseCommandLine(int argc, char** argv, CommandLine& commandLine)
+{
+	int arg = 1;
+
+	for (; arg < argc && argv[arg][0] == '-'; ++arg)
+	{
+		if (std::strcmp(argv[arg], "-v") == 0)
+		{
+			aoc::diagnostics().setVerbosity(aoc::Verbosity::Summary);
+		}
+		else if (std::strcmp(argv[arg], "-vv") == 0)
+		{
+			aoc::diagnostics().setVerbosity(aoc::Verbosity::Detail);
+		}
+		else if (std::strcmp(argv[arg], "--json") == 0)
+		{
+			commandLine.json = true;
+			aoc::diagnostics().setFormat(aoc::DiagnosticsFormat::Json);
+		}
+		else if (std::strcmp(argv[arg], "--calibrate") == 0)
+		{
+			commandLine.calibrate = true;
+		}
+		else if (std::strcmp(argv[arg], "--tuning") == 0 && arg + 1 < argc)
+		{
+			commandLine.tuningFile = argv[arg + 1];
+			++arg;
+		}
+		else if (std::strcmp(argv[arg], "--bench") == 0)
+		{
+			commandLine.benchmark = true;
+		}
+		else if (std::strcmp(argv[arg], "--check-prefetch") == 0)
+		{
+			commandLine.checkPrefetch = true;
+		}
+		else if (std::strcmp(argv[arg], "--shards") == 0 && arg + 1 < argc)
+		{
+			commandLine.shards = (unsigned) std::atoi(argv[arg + 1]);
+			++arg;
+		}
+		else if (std::strcmp(argv[arg], "--budget") == 0 && arg + 1 < argc)
+		{
+			commandLine.options.budget = std::chrono::milliseconds((int64_t) (std::atof(argv[arg + 1]) * 1000.0));
+			++arg;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	commandLine.firstJob = arg;
+
+	return (argc - arg) % 2 == 0;
+}
+
+static const char* toString(aoc::RunStatus status)
 {
+	switch (status)
+	{
+		case aoc::RunStatus::Solved: return "solved";
+		case aoc::RunStatus::Cancelled: return "cancelled";
+		case aoc::RunStatus::Failed: return "failed";
+	}
+
+	return "unknown";
+}
+
+static void printResult(const CommandLine& commandLine, const char* filename, const aoc::RunResult& result)
+{
+	const std::string stage = result.lastProgress ? std::string(result.lastProgress->stage) : "startup";
+
+	if (commandLine.json)
+	{
+		std::printf("{\"day\":%d,\"input\":\"%s\",\"status\":\"%s\",\"seconds\":%.6f",
+			result.day, aoc::jsonEscape(filename).c_str(), toString(result.status), result.elapsed.count());
+
+		if (result.status == aoc::RunStatus::Solved)
+			std::printf(",\"partOne\":\"%s\",\"partTwo\":\"%s\"}\n", result.partOne.c_str(), result.partTwo.c_str());
+		else if (result.status == aoc::RunStatus::Cancelled)
+			std::printf(",\"stage\":\"%s\"}\n", aoc::jsonEscape(stage).c_str());
+		else
+			std::printf("}\n");
+	}
+	else if (result.status == aoc::RunStatus::Solved)
+	{
+		std::printf("Day %02d %s: Part 1: %s Part 2: %s (%.3fs)\n", result.day, filename, result.partOne.c_str(), result.partTwo.c_str(), result.elapsed.count());
+	}
+	else if (result.status == aoc::RunStatus::Cancelled)
+	{
+		std::printf("Day %02d %s: Cancelled after %.3fs during %s\n", result.day, filename, result.elapsed.count(), stage.c_str());
+	}
+	else
+	{
+		std::printf("Day %02d %s: Failed after %.3fs\n", result.day, filename, result.elapsed.count());
+	}
+}
+
+// Solves each day/input pair given on the command line, cancelling any that overrun the time budget.
+// Returns non-zero if any of them were cancelled or the arguments were invalid.
+static int runBatch(int argc, char** argv, CommandLine& commandLine)
+{
+	aoc::RunOptions& options = commandLine.options;
+
+	int exitCode = 0;
+
+	const auto isSharded = [&commandLine] (int day) { return commandLine.shards > 1 && aoc::isShardable(day); };
+
+	// Sharded runs fork worker processes, so they're solved before the prefetcher starts any threads
+	// for the workers to inherit mid-flight, and their results are printed in turn with the others'.
+	// They have no time budget, the worker processes always run to completion.
+	std::vector<std::optional<aoc::RunResult>> shardedResults((size_t) argc);
+
+	for (int arg = commandLine.firstJob; arg < argc; arg += 2)
+		if (aoc::isValidDay(std::atoi(argv[arg])) && isSharded(std::atoi(argv[arg])))
+			shardedResults[(size_t) arg] = aoc::runSharded(std::atoi(argv[arg]), argv[arg + 1], commandLine.shards);
+
+	// Inputs are read ahead in the background while earlier ones are being solved.
+	// Sharded runs map their files themselves.
+	std::vector<std::string> prefetchFilenames;
+
+	for (int arg = commandLine.firstJob; arg < argc; arg += 2)
+		if (aoc::isValidDay(std::atoi(argv[arg])) && !isSharded(std::atoi(argv[arg])))
+			prefetchFilenames.emplace_back(argv[arg + 1]);
+
+	aoc::FilePrefetcher prefetcher(std::move(prefetchFilenames));
+	aoc::diagnostics().write(aoc::Verbosity::Summary, "prefetch", std::string("Reading inputs with ") + prefetcher.backendName());
+
+	for (int arg = commandLine.firstJob; arg < argc; arg += 2)
+	{
+		const int day = std::atoi(argv[arg]);
+		const char* filename = argv[arg + 1];
+
+		if (!aoc::isValidDay(day))
+		{
+			std::fprintf(stderr, "Invalid day: %s\n", argv[arg]);
+			exitCode = 2;
+			continue;
+		}
+
+		// Progress is reported at most once a second, so that chatty solvers don't flood the console.
+		auto lastReport = std::chrono::steady_clock::now();
+		options.onProgress = [&lastReport, day] (const aoc::Progress& progress)
+		{
+			const auto now = std::chrono::steady_clock::now();
+			if (now - lastReport < std::chrono::seconds(1))
+				return;
+
+			lastReport = now;
+
+			if (progress.total > 0)
+				std::fprintf(stderr, "Day %02d: %s %llu/%llu\n", day, std::string(progress.stage).c_str(), (unsigned long long) progress.done, (unsigned long long) progress.total);
+			else
+				std::fprintf(stderr, "Day %02d: %s %llu\n", day, std::string(progress.stage).c_str(), (unsigned long long) progress.done);
+		};
+
+		aoc::RunResult result;
+
+		if (shardedResults[(size_t) arg])
+		{
+			result = *shardedResults[(size_t) arg];
+		}
+		else if (const std::optional<std::string> input = prefetcher.next())
+		{
+			if (commandLine.calibrate)
+				aoc::calibrateSolver(day, *input);
+
+			result = aoc::runSolver(day, *input, options);
+		}
+		else
+		{
+			result.day = day;
+			result.status = aoc::RunStatus::Failed;
+		}
+
+		aoc::diagnostics().flush();
+		printResult(commandLine, filename, result);
+
+		if (result.status != aoc::RunStatus::Solved)
+			exitCode = 1;
+	}
+
+	if (commandLine.calibrate && !aoc::saveTuning(commandLine.tuningFile))
+	{
+		std::fprintf(stderr, "Failed to save tuning file: %s\n", commandLine.tuningFile);
+		exitCode = 2;
+	}
+
+	return exitCode;
+}
+
+int main(int argc, char** argv)
+{
+	CommandLine commandLine;
+
+	if (!parseCommandLine(argc, argv, commandLine))
+	{
+		printUsage();
+		return 2;
+	}
+
+	if (commandLine.benchmark)
+		aoc::benchmarkGridTransforms();
+
+	if (commandLine.checkPrefetch)
+		aoc::checkFilePrefetcher();
+
+	if ((commandLine.benchmark || commandLine.checkPrefetch) && commandLine.firstJob >= argc)
+		return 0;
+
+	// Missing tuning files are fine, the solvers fall back to choosing variants heuristically.
+	aoc::loadTuning(commandLine.tuningFile);
+
+	if (commandLine.firstJob < argc)
+		return runBatch(argc, argv, commandLine);
+
 	extern void currentday();
 	currentday();
 
+	aoc::diagnostics().flush();
+
 	return 0;
 }
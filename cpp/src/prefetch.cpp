@@ -0,0 +1,576 @@
+#include "prefetch.h"
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stop_token>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define AOC_HAS_PREAD 1
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <atomic>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define AOC_HAS_IO_URING 1
+#endif
+
+class aoc::FilePrefetcher::Backend
+{
+public:
+	virtual ~Backend() = default;
+
+	virtual std::optional<std::string> next() = 0;
+	virtual const char* name() const = 0;
+};
+
+// Largest single read, comfortably inside the 32-bit length of an io_uring read.
+static constexpr size_t MaxReadSize = size_t(1) << 30;
+
+// Reads until the end of the file, for files whose size isn't known up front, such as pipes and procfs files.
+static std::optional<std::string> readStreamed(const std::string& filename)
+{
+	std::ifstream s{ filename, s.in | s.binary };
+	if (!s.is_open())
+		return {};
+
+	std::stringstream buffer;
+	buffer << s.rdbuf();
+	return buffer.str();
+}
+
+#if defined(AOC_HAS_PREAD)
+
+static std::optional<std::string> readWholeFile(const std::string& filename)
+{
+	const int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return {};
+
+	struct stat info = {};
+	if (fstat(fd, &info) != 0)
+	{
+		close(fd);
+		return {};
+	}
+
+	// Pipes have no size, and procfs files claim to be empty, so only non-empty regular files are read by size.
+	if (!S_ISREG(info.st_mode) || info.st_size == 0)
+	{
+		close(fd);
+		return readStreamed(filename);
+	}
+
+	std::string contents((size_t) info.st_size, '\0');
+	size_t done = 0;
+
+	while (done < contents.size())
+	{
+		const ssize_t bytesRead = pread(fd, contents.data() + done, std::min(contents.size() - done, MaxReadSize), (off_t) done);
+
+		if (bytesRead < 0 && errno == EINTR)
+			continue;
+
+		if (bytesRead < 0)
+		{
+			close(fd);
+			return {};
+		}
+
+		// The file shrank since fstat().
+		if (bytesRead == 0)
+		{
+			contents.resize(done);
+			break;
+		}
+
+		done += (size_t) bytesRead;
+	}
+
+	close(fd);
+
+	return contents;
+}
+
+#else
+
+static std::optional<std::string> readWholeFile(const std::string& filename)
+{
+	return readStreamed(filename);
+}
+
+#endif
+
+// Reads files in order on a background thread, staying at most readAhead files ahead of next().
+class ThreadBackend : public aoc::FilePrefetcher::Backend
+{
+public:
+	ThreadBackend(std::vector<std::string> _filenames, size_t _readAhead)
+		: filenames(std::move(_filenames))
+		, readAhead(_readAhead)
+		, reader([this] (std::stop_token stopToken) { readFiles(stopToken); })
+	{
+	}
+
+	std::optional<std::string> next() override
+	{
+		assert(taken < filenames.size());
+
+		std::unique_lock lock(mutex);
+		changed.wait(lock, [this] { return !ready.empty(); });
+
+		std::optional<std::string> contents = std::move(ready.front());
+		ready.pop_front();
+		++taken;
+
+		changed.notify_all();
+
+		return contents;
+	}
+
+	const char* name() const override { return "thread"; }
+
+private:
+	void readFiles(std::stop_token stopToken)
+	{
+		for (const std::string& filename : filenames)
+		{
+			{
+				std::unique_lock lock(mutex);
+				if (!changed.wait(lock, stopToken, [this] { return ready.size() < readAhead; }))
+					return;
+			}
+
+			std::optional<std::string> contents = readWholeFile(filename);
+
+			std::lock_guard lock(mutex);
+			ready.push_back(std::move(contents));
+			changed.notify_all();
+		}
+	}
+
+	std::vector<std::string> filenames;
+	size_t readAhead;
+	size_t taken = 0;
+
+	std::mutex mutex;
+	std::condition_variable_any changed;
+	std::deque<std::optional<std::string>> ready;
+
+	// Last, so that it starts after and stops before everything it uses.
+	std::jthread reader;
+};
+
+#if defined(AOC_HAS_IO_URING)
+
+// The minimum of io_uring needed to queue reads, talking to the kernel directly rather than through liburing.
+class Uring
+{
+public:
+	// submissionToRefuse is for checking recovery: that submission, counting from 0, is refused as
+	// the kernel would when briefly out of resources, leaving its entry queued. Later ones go through.
+	explicit Uring(unsigned entries, size_t _submissionToRefuse = SIZE_MAX)
+		: submissionToRefuse(_submissionToRefuse)
+	{
+		io_uring_params params;
+		std::memset(&params, 0, sizeof(params));
+
+		ringFd = (int) syscall(__NR_io_uring_setup, entries, &params);
+		if (ringFd < 0)
+			return;
+
+		// IORING_OP_READ arrived in the same kernel as this feature flag, 5.6.
+		if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_RW_CUR_POS))
+			return;
+
+		ringSize = std::max(
+			params.sq_off.array + params.sq_entries * sizeof(unsigned),
+			params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+
+		ring = mmap(nullptr, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+		if (ring == MAP_FAILED)
+		{
+			ring = nullptr;
+			return;
+		}
+
+		sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		void* sqesMapping = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+		if (sqesMapping == MAP_FAILED)
+			return;
+
+		char* base = static_cast<char*>(ring);
+
+		sqTail = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+		sqMask = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+		sqArray = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+		sqes = static_cast<io_uring_sqe*>(sqesMapping);
+
+		cqHead = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+		cqTail = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+		cqMask = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+		cqes = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+	}
+
+	~Uring()
+	{
+		if (sqes)
+			munmap(sqes, sqesSize);
+
+		if (ring)
+			munmap(ring, ringSize);
+
+		if (ringFd >= 0)
+			close(ringFd);
+	}
+
+	Uring(const Uring&) = delete;
+	Uring& operator=(const Uring&) = delete;
+
+	bool isValid() const { return sqes != nullptr; }
+
+	// Callers must keep the number of reads in flight within the ring's size.
+	// Returns false if the kernel didn't take the read, in which case no completion will come for it.
+	// Its entry is left in the submission queue, so the ring mustn't be submitted to again.
+	bool submitRead(int fd, char* buffer, unsigned length, uint64_t offset, uint64_t userData)
+	{
+		const unsigned tail = *sqTail;
+		const unsigned index = tail & sqMask;
+
+		io_uring_sqe& sqe = sqes[index];
+		std::memset(&sqe, 0, sizeof(sqe));
+		sqe.opcode = IORING_OP_READ;
+		sqe.fd = fd;
+		sqe.addr = (uint64_t) (uintptr_t) buffer;
+		sqe.len = length;
+		sqe.off = offset;
+		sqe.user_data = userData;
+
+		sqArray[index] = index;
+		std::atomic_ref<unsigned>(*sqTail).store(tail + 1, std::memory_order_release);
+
+		if (numSubmissions++ == submissionToRefuse)
+			return false;
+
+		int submitted = 0;
+		do
+		{
+			submitted = (int) syscall(__NR_io_uring_enter, ringFd, 1, 0, 0, nullptr, 0);
+		}
+		while (submitted < 0 && errno == EINTR);
+
+		return submitted == 1;
+	}
+
+	io_uring_cqe waitForCompletion()
+	{
+		for (;;)
+		{
+			const unsigned head = *cqHead;
+
+			if (head != std::atomic_ref<unsigned>(*cqTail).load(std::memory_order_acquire))
+			{
+				const io_uring_cqe completion = cqes[head & cqMask];
+				std::atomic_ref<unsigned>(*cqHead).store(head + 1, std::memory_order_release);
+				return completion;
+			}
+
+			const int result = (int) syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+			assert(result >= 0 || errno == EINTR);
+			(void) result;
+		}
+	}
+
+private:
+	size_t submissionToRefuse = SIZE_MAX;
+	size_t numSubmissions = 0;
+
+	int ringFd = -1;
+
+	void* ring = nullptr;
+	size_t ringSize = 0;
+
+	io_uring_sqe* sqes = nullptr;
+	size_t sqesSize = 0;
+
+	unsigned* sqTail = nullptr;
+	unsigned sqMask = 0;
+	unsigned* sqArray = nullptr;
+
+	unsigned* cqHead = nullptr;
+	unsigned* cqTail = nullptr;
+	unsigned cqMask = 0;
+	io_uring_cqe* cqes = nullptr;
+};
+
+// Keeps reads of the next readAhead files in flight on an io_uring, one chunk per file at a time.
+// Files without a known size are read when taken, as are any whose reads the ring fails to take,
+// after which the files the ring hasn't started are left to a ThreadBackend.
+class UringBackend : public aoc::FilePrefetcher::Backend
+{
+public:
+	UringBackend(std::vector<std::string> _filenames, size_t _readAhead, size_t _maxReadSize = MaxReadSize, size_t submissionToRefuse = SIZE_MAX)
+		: filenames(std::move(_filenames))
+		, files(filenames.size())
+		, readAhead(_readAhead)
+		, maxReadSize(_maxReadSize)
+		, ring((unsigned) _readAhead, submissionToRefuse)
+	{
+		if (ring.isValid())
+			queueReads();
+	}
+
+	~UringBackend() override
+	{
+		// The kernel may still be writing into buffers of files that were never taken.
+		while (inFlight > 0)
+			complete(ring.waitForCompletion());
+
+		for (PendingFile& file : files)
+			if (file.fd >= 0)
+				close(file.fd);
+	}
+
+	bool isValid() const { return ring.isValid(); }
+
+	std::optional<std::string> next() override
+	{
+		assert(nextToReturn < files.size());
+
+		if (fallback && nextToReturn >= fallbackStart)
+		{
+			++nextToReturn;
+			return fallback->next();
+		}
+
+		const size_t index = nextToReturn;
+		PendingFile& file = files[index];
+
+		while (!file.finished)
+			complete(ring.waitForCompletion());
+
+		++nextToReturn;
+		queueReads();
+
+		if (file.streamed)
+			return readStreamed(filenames[index]);
+
+		if (file.failed)
+			return {};
+
+		return std::move(file.contents);
+	}
+
+	const char* name() const override { return "io_uring"; }
+
+private:
+	struct PendingFile
+	{
+		int fd = -1;
+		std::string contents;
+		size_t done = 0;
+		bool finished = false;
+		bool failed = false;
+		bool streamed = false; // read when taken instead
+	};
+
+	void queueReads()
+	{
+		while (!ringFailed && nextToQueue < files.size() && nextToQueue < nextToReturn + readAhead)
+			start(nextToQueue++);
+
+		if (ringFailed && !fallback && nextToQueue < files.size())
+		{
+			fallback = std::make_unique<ThreadBackend>(std::vector<std::string>(begin(filenames) + (ptrdiff_t) nextToQueue, end(filenames)), readAhead);
+			fallbackStart = nextToQueue;
+		}
+	}
+
+	void start(size_t index)
+	{
+		PendingFile& file = files[index];
+
+		file.fd = open(filenames[index].c_str(), O_RDONLY | O_CLOEXEC);
+
+		struct stat info = {};
+		if (file.fd < 0 || fstat(file.fd, &info) != 0)
+		{
+			finish(file, true);
+			return;
+		}
+
+		// Pipes have no size, and procfs files claim to be empty, so only non-empty regular files are read by size.
+		if (!S_ISREG(info.st_mode) || info.st_size == 0)
+		{
+			file.streamed = true;
+			finish(file, false);
+			return;
+		}
+
+		file.contents.resize((size_t) info.st_size);
+		submitChunk(index);
+	}
+
+	// Once a read has been refused its entry stays queued, and the next submission would send it in
+	// place of the new one, so files with chunks left to read are read when taken instead.
+	void submitChunk(size_t index)
+	{
+		PendingFile& file = files[index];
+		const size_t length = std::min(file.contents.size() - file.done, maxReadSize);
+
+		if (ringFailed || !ring.submitRead(file.fd, file.contents.data() + file.done, (unsigned) length, file.done, index))
+		{
+			ringFailed = true;
+			file.streamed = true;
+			finish(file, false);
+			return;
+		}
+
+		++inFlight;
+	}
+
+	void complete(const io_uring_cqe& completion)
+	{
+		--inFlight;
+
+		const size_t index = (size_t) completion.user_data;
+		PendingFile& file = files[index];
+
+		// Refused entries are never submitted, so no completions come for files already finished.
+		assert(!file.finished);
+		if (file.finished)
+			return;
+
+		if (completion.res == -EINTR || completion.res == -EAGAIN)
+		{
+			submitChunk(index);
+		}
+		else if (completion.res < 0)
+		{
+			finish(file, true);
+		}
+		else if (completion.res == 0)
+		{
+			// The file shrank since fstat().
+			file.contents.resize(file.done);
+			finish(file, false);
+		}
+		else
+		{
+			file.done += (size_t) completion.res;
+
+			if (file.done == file.contents.size())
+				finish(file, false);
+			else
+				submitChunk(index);
+		}
+	}
+
+	static void finish(PendingFile& file, bool failed)
+	{
+		if (file.fd >= 0)
+			close(file.fd);
+
+		file.fd = -1;
+		file.finished = true;
+		file.failed = failed;
+
+		if (failed)
+			file.contents.clear();
+	}
+
+	std::vector<std::string> filenames;
+	std::vector<PendingFile> files;
+	size_t readAhead;
+	size_t maxReadSize;
+
+	size_t nextToQueue = 0;
+	size_t nextToReturn = 0;
+	size_t inFlight = 0;
+
+	Uring ring;
+	bool ringFailed = false;
+
+	std::unique_ptr<aoc::FilePrefetcher::Backend> fallback;
+	size_t fallbackStart = 0;
+};
+
+#endif
+
+aoc::FilePrefetcher::FilePrefetcher(std::vector<std::string> filenames, size_t readAhead)
+{
+	assert(readAhead > 0);
+
+#if defined(AOC_HAS_IO_URING)
+	auto uring = std::make_unique<UringBackend>(filenames, readAhead);
+	if (uring->isValid())
+	{
+		backend = std::move(uring);
+		return;
+	}
+#endif
+
+	backend = std::make_unique<ThreadBackend>(std::move(filenames), readAhead);
+}
+
+aoc::FilePrefetcher::~FilePrefetcher() = default;
+
+std::optional<std::string> aoc::FilePrefetcher::next()
+{
+	return backend->next();
+}
+
+const char* aoc::FilePrefetcher::backendName() const
+{
+	return backend->name();
+}
+
+void aoc::checkFilePrefetcher()
+{
+#if defined(AOC_HAS_IO_URING)
+	const std::filesystem::path directory = std::filesystem::temp_directory_path();
+	const std::string manyChunksFile = (directory / "aoc_prefetch_many_chunks.txt").string();
+	const std::string fewChunksFile = (directory / "aoc_prefetch_few_chunks.txt").string();
+
+	static constexpr size_t ChunkSize = 1024;
+
+	std::string manyChunks;
+	for (size_t i = 0; manyChunks.size() < ChunkSize * 10; ++i)
+		manyChunks += std::to_string(i) + '\n';
+
+	const std::string fewChunks = manyChunks.substr(0, (ChunkSize * 2) + 100);
+
+	std::ofstream(manyChunksFile, std::ios::binary) << manyChunks;
+	std::ofstream(fewChunksFile, std::ios::binary) << fewChunks;
+
+	// Refusing each submission in turn covers the ring failing before, during and after each file,
+	// with the other file's reads in flight, and the files after them left to the fallback.
+	for (size_t submissionToRefuse = 0; submissionToRefuse <= 16; ++submissionToRefuse)
+	{
+		UringBackend backend({ manyChunksFile, fewChunksFile, manyChunksFile, fewChunksFile }, 2, ChunkSize, submissionToRefuse);
+		if (!backend.isValid())
+			break;
+
+		assert(backend.next() == manyChunks);
+		assert(backend.next() == fewChunks);
+		assert(backend.next() == manyChunks);
+		assert(backend.next() == fewChunks);
+	}
+
+	std::filesystem::remove(manyChunksFile);
+	std::filesystem::remove(fewChunksFile);
+#endif
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace aoc
+{
+	// Reads a list of input files ahead of when they're needed, so that solving one input
+	// overlaps with reading the next few instead of blocking on each open and read.
+	//
+	// On Linux the reads are queued with io_uring. Where io_uring is unavailable (older kernels,
+	// seccomp filtered containers) or on other platforms, a background thread reads ahead instead.
+	class FilePrefetcher
+	{
+	public:
+		explicit FilePrefetcher(std::vector<std::string> filenames, size_t readAhead = 4);
+		~FilePrefetcher();
+
+		// Contents of the next file in the list, waiting for its read to finish if need be.
+		// Empty if the file couldn't be read.
+		std::optional<std::string> next();
+
+		// "io_uring" or "thread", for diagnostics.
+		const char* backendName() const;
+
+		class Backend;
+
+	private:
+		std::unique_ptr<Backend> backend;
+	};
+
+	// Checks that io_uring reads recover through the fallbacks when the kernel refuses a submission
+	// partway through a file read in several chunks, by refusing each submission in turn. Asserts on failure.
+	void checkFilePrefetcher();
+}
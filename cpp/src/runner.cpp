@@ -0,0 +1,113 @@
+#include "runner.h"
+
+#include <array>
+#include <cassert>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "aoc.h"
+#include "diagnostics.h"
+#include "dispatch.h"
+
+using SolverFn = std::pair<std::string, std::string>(*)(std::string_view, const aoc::SolveContext&);
+
+template <typename T>
+static std::pair<std::string, std::string> toStrings(const aoc::Answers<T>& answers)
+{
+	return { std::to_string(answers.partOne), std::to_string(answers.partTwo) };
+}
+
+static constexpr std::array<SolverFn, aoc::NumDays> solvers =
+{
+	[] (std::string_view input, const aoc::SolveContext&) { return toStrings(aoc::solveDay01(input)); },
+	[] (std::string_view input, const aoc::SolveContext&) { return toStrings(aoc::solveDay02(input)); },
+	[] (std::string_view input, const aoc::SolveContext&) { return toStrings(aoc::solveDay03(input)); },
+	[] (std::string_view input, const aoc::SolveContext&) { return toStrings(aoc::solveDay04(input)); },
+	[] (std::string_view input, const aoc::SolveContext&) { return toStrings(aoc::solveDay05(input)); },
+	[] (std::string_view input, const aoc::SolveContext&) { return toStrings(aoc::solveDay06(input)); },
+	[] (std::string_view input, const aoc::SolveContext&) { return toStrings(aoc::solveDay07(input)); },
+	[] (std::string_view input, const aoc::SolveContext& context) { return toStrings(aoc::solveDay08(input, context)); },
+	[] (std::string_view input, const aoc::SolveContext&) { return toStrings(aoc::solveDay09(input)); },
+	[] (std::string_view input, const aoc::SolveContext&) { return toStrings(aoc::solveDay10(input)); },
+	[] (std::string_view input, const aoc::SolveContext&) { return toStrings(aoc::solveDay11(input)); },
+	[] (std::string_view input, const aoc::SolveContext& context) { return toStrings(aoc::solveDay12(input, context)); },
+	[] (std::string_view input, const aoc::SolveContext&) { return toStrings(aoc::solveDay13(input)); },
+	[] (std::string_view input, const aoc::SolveContext& context) { return toStrings(aoc::solveDay14(input, context)); },
+	[] (std::string_view input, const aoc::SolveContext&) { return toStrings(aoc::solveDay15(input)); },
+	[] (std::string_view input, const aoc::SolveContext& context) { return toStrings(aoc::solveDay16(input, context)); },
+};
+
+bool aoc::isValidDay(int day)
+{
+	return 1 <= day && day <= NumDays;
+}
+
+aoc::RunResult aoc::runSolver(int day, std::string_view input, const RunOptions& options)
+{
+	assert(isValidDay(day));
+
+	RunResult result;
+	result.day = day;
+
+	std::stop_source stopSource;
+
+	const SolveContext context(stopSource.get_token(), [&result, &options] (const Progress& progress)
+	{
+		result.lastProgress = progress;
+
+		if (options.onProgress)
+			options.onProgress(progress);
+	});
+
+	// The solver runs on this thread, while a watchdog requests a stop if it overruns its budget.
+	// The watchdog is woken and joined when it goes out of scope, if the solver finishes first.
+	std::jthread watchdog;
+
+	if (options.budget.count() > 0)
+	{
+		watchdog = std::jthread([&stopSource, budget = options.budget] (std::stop_token watchdogToken)
+		{
+			std::mutex mutex;
+			std::condition_variable_any wakeUp;
+			std::unique_lock lock(mutex);
+
+			wakeUp.wait_for(lock, watchdogToken, budget, [] { return false; });
+
+			if (!watchdogToken.stop_requested())
+				stopSource.request_stop();
+		});
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+
+	try
+	{
+		std::tie(result.partOne, result.partTwo) = solvers[day - 1](input, context);
+	}
+	catch (const Cancelled&)
+	{
+		result.status = RunStatus::Cancelled;
+	}
+	catch (const std::exception& e)
+	{
+		// e.g. bad_alloc, or a parse error from malformed input. Only this day fails, the rest of the batch still runs.
+		result.status = RunStatus::Failed;
+		diagnostics().write(Verbosity::Summary, "runner", "Day " + std::to_string(day) + " failed: " + e.what());
+	}
+
+	result.elapsed = std::chrono::steady_clock::now() - start;
+
+	return result;
+}
+
+void aoc::calibrateSolver(int day, std::string_view input)
+{
+	assert(isValidDay(day));
+
+	calibrate(day, [day, input] { solvers[day - 1](input, {}); });
+}
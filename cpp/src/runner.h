@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "solvecontext.h"
+
+namespace aoc
+{
+	constexpr int NumDays = 16;
+
+	enum class RunStatus
+	{
+		Solved,
+		Cancelled,
+		Failed
+	};
+
+	struct RunResult
+	{
+		int day = 0;
+		RunStatus status = RunStatus::Solved;
+		std::string partOne;
+		std::string partTwo;
+		std::chrono::duration<double> elapsed{};
+		std::optional<Progress> lastProgress;
+	};
+
+	struct RunOptions
+	{
+		// Solvers still running after this long are cancelled. Zero means no limit.
+		std::chrono::milliseconds budget{ 0 };
+		std::function<void(const Progress&)> onProgress;
+	};
+
+	bool isValidDay(int day);
+
+	// Solves one day's input, cancelling the solver if it overruns its time budget.
+	RunResult runSolver(int day, std::string_view input, const RunOptions& options);
+
+	// Times each variant of the day's dispatched kernels on the input, and records the fastest.
+	void calibrateSolver(int day, std::string_view input);
+}
@@ -0,0 +1,246 @@
+#include "shard.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include "aoc.h"
+#include "input.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define AOC_HAS_FORK 1
+#endif
+
+using ShardAnswers = aoc::Answers<int64_t>;
+
+template <typename T>
+static ShardAnswers widen(const aoc::Answers<T>& answers)
+{
+	return { (int64_t) answers.partOne, (int64_t) answers.partTwo };
+}
+
+static ShardAnswers solveWhole(int day, std::string_view input)
+{
+	switch (day)
+	{
+		case 1: return widen(aoc::solveDay01(input));
+		case 2: return widen(aoc::solveDay02(input));
+		case 9: return widen(aoc::solveDay09(input));
+		case 12: return widen(aoc::solveDay12(input));
+	}
+
+	assert(false);
+
+	return {};
+}
+
+// A shard's answers, or none where they depend on the rest of the input, which must then be solved whole.
+static std::optional<ShardAnswers> solveShard(int day, std::string_view shard)
+{
+	if (day == 2)
+	{
+		const std::optional<aoc::Answers<>> answers = aoc::solveDay02Piece(shard);
+		return answers ? std::optional<ShardAnswers>(widen(*answers)) : std::nullopt;
+	}
+
+	return solveWhole(day, shard);
+}
+
+static void accumulate(ShardAnswers& total, const ShardAnswers& shard)
+{
+	total.partOne += shard.partOne;
+	total.partTwo += shard.partTwo;
+}
+
+bool aoc::isShardable(int day)
+{
+	return day == 1 || day == 2 || day == 9 || day == 12;
+}
+
+std::vector<std::string_view> aoc::splitAtLines(std::string_view input, size_t numShards)
+{
+	assert(numShards > 0);
+
+	std::vector<std::string_view> shards;
+	size_t shardBegin = 0;
+
+	for (size_t i = 1; i <= numShards && shardBegin < input.size(); ++i)
+	{
+		size_t shardEnd = input.size();
+
+		if (i < numShards)
+		{
+			// Move the even split point forward to just after the next line break.
+			const size_t lineBreak = input.find('\n', std::max(shardBegin, (input.size() * i) / numShards));
+			shardEnd = (lineBreak == std::string_view::npos) ? input.size() : lineBreak + 1;
+		}
+
+		shards.push_back(input.substr(shardBegin, shardEnd - shardBegin));
+		shardBegin = shardEnd;
+	}
+
+	return shards;
+}
+
+#if defined(AOC_HAS_FORK)
+
+// Each worker writes its answers into its own slot of an anonymous shared mapping before exiting.
+struct ShardSlot
+{
+	ShardAnswers answers;
+	bool solved;
+	bool needsWholeInput;
+};
+
+static std::optional<ShardAnswers> solveShards(int day, const char* filename, unsigned numWorkers)
+{
+	const int fd = open(filename, O_RDONLY);
+	if (fd < 0)
+		return {};
+
+	struct stat info = {};
+	if (fstat(fd, &info) != 0)
+	{
+		close(fd);
+		return {};
+	}
+
+	if (info.st_size == 0)
+	{
+		close(fd);
+		return ShardAnswers{};
+	}
+
+	const size_t fileSize = (size_t) info.st_size;
+	void* file = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (file == MAP_FAILED)
+		return {};
+
+	const std::vector<std::string_view> shards = aoc::splitAtLines(std::string_view((const char*) file, fileSize), numWorkers);
+
+	const size_t slotsSize = sizeof(ShardSlot) * shards.size();
+	void* slotsMapping = mmap(nullptr, slotsSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+	if (slotsMapping == MAP_FAILED)
+	{
+		munmap(file, fileSize);
+		return {};
+	}
+
+	// Anonymous mappings are zero filled, so every slot starts out unsolved.
+	ShardSlot* slots = static_cast<ShardSlot*>(slotsMapping);
+
+	std::vector<pid_t> workers;
+
+	for (size_t i = 0; i < shards.size(); ++i)
+	{
+		const pid_t pid = fork();
+
+		if (pid == 0)
+		{
+			// The workers between them already keep every core busy.
+			aoc::restrictToOneThread();
+
+			if (const std::optional<ShardAnswers> answers = solveShard(day, shards[i]))
+				slots[i].answers = *answers;
+			else
+				slots[i].needsWholeInput = true;
+
+			slots[i].solved = true;
+
+			// Skip atexit handlers and stdio flushes, which belong to the coordinator.
+			_exit(0);
+		}
+
+		if (pid < 0)
+			break;
+
+		workers.push_back(pid);
+	}
+
+	bool succeeded = workers.size() == shards.size();
+
+	for (const pid_t pid : workers)
+	{
+		int status = 0;
+		while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+		{
+		}
+
+		succeeded = succeeded && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+	}
+
+	ShardAnswers total;
+	bool needsWholeInput = false;
+
+	for (size_t i = 0; i < shards.size(); ++i)
+	{
+		succeeded = succeeded && slots[i].solved;
+		needsWholeInput = needsWholeInput || slots[i].needsWholeInput;
+		accumulate(total, slots[i].answers);
+	}
+
+	if (succeeded && needsWholeInput)
+		total = solveWhole(day, std::string_view((const char*) file, fileSize));
+
+	munmap(slotsMapping, slotsSize);
+	munmap(file, fileSize);
+
+	return succeeded ? std::optional<ShardAnswers>(total) : std::nullopt;
+}
+
+#else
+
+static std::optional<ShardAnswers> solveShards(int day, const char* filename, unsigned numWorkers)
+{
+	const std::string input = aoc::readFile(filename);
+
+	ShardAnswers total;
+
+	for (const std::string_view shard : aoc::splitAtLines(input, numWorkers))
+	{
+		const std::optional<ShardAnswers> answers = solveShard(day, shard);
+		if (!answers)
+			return solveWhole(day, input);
+
+		accumulate(total, *answers);
+	}
+
+	return total;
+}
+
+#endif
+
+aoc::RunResult aoc::runSharded(int day, const char* filename, unsigned numWorkers)
+{
+	assert(isShardable(day) && numWorkers > 0);
+
+	RunResult result;
+	result.day = day;
+
+	const auto start = std::chrono::steady_clock::now();
+	const std::optional<ShardAnswers> answers = solveShards(day, filename, numWorkers);
+	result.elapsed = std::chrono::steady_clock::now() - start;
+
+	if (answers)
+	{
+		result.partOne = std::to_string(answers->partOne);
+		result.partTwo = std::to_string(answers->partTwo);
+	}
+	else
+	{
+		result.status = RunStatus::Failed;
+	}
+
+	return result;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "dispatch.h"
+#include "runner.h"
+
+// Solving one huge input across several worker processes, or threads.
+//
+// Only days whose answers are sums of independent per-line answers can be sharded:
+// 01, 02, 09 and 12. Day 02's powers depend on every colour in the log, so if any shard
+// shows colours other than the puzzle's, the input is solved again in one piece.
+// Day 04's card copies and day 07's ranking both depend on the whole input, so those
+// days are solved in one piece.
+
+namespace aoc
+{
+	bool isShardable(int day);
+
+	// Splits the input into at most numShards pieces of roughly equal size, each ending on a line boundary.
+	std::vector<std::string_view> splitAtLines(std::string_view input, size_t numShards);
+
+	// Splits the input at line boundaries into a chunk per hardware thread, or as many as given, and
+	// solves each chunk on its own thread, this thread taking the first. Returns the chunks' results in order.
+	template <typename Solve>
+	auto solveChunksInParallel(std::string_view input, const Solve& solve, size_t numChunks = cpuFeatures().hardwareThreads)
+	{
+		const std::vector<std::string_view> chunks = splitAtLines(input, numChunks);
+		std::vector<decltype(solve(input))> results(chunks.size());
+
+		{
+			std::vector<std::jthread> workers;
+
+			for (size_t i = 1; i < chunks.size(); ++i)
+				workers.emplace_back([&, i] { results[i] = solve(chunks[i]); });
+
+			if (!chunks.empty())
+				results[0] = solve(chunks[0]);
+		}
+
+		return results;
+	}
+
+	// Maps the file into memory shared with numWorkers forked worker processes, each of which solves
+	// one shard without the multithreaded variants, and sums their answers. Forking must happen before
+	// the process starts any other threads. Where fork() isn't available the shards are solved in turn
+	// in this process instead.
+	RunResult runSharded(int day, const char* filename, unsigned numWorkers);
+}
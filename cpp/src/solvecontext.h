@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+
+namespace aoc
+{
+	struct Progress
+	{
+		std::string_view stage; // always a string literal, so it outlives the solver
+		uint64_t done = 0;
+		uint64_t total = 0; // 0 when the total isn't known up front
+	};
+
+	// Thrown out of a solver when a stop was requested on its SolveContext.
+	class Cancelled : public std::runtime_error
+	{
+	public:
+		explicit Cancelled(std::string_view stage)
+			: std::runtime_error("Cancelled during " + std::string(stage))
+		{
+		}
+	};
+
+	// Passed to solvers that can run for a long time.
+	// Their long loops call checkpoint() periodically, which reports progress and
+	// unwinds the solver by throwing aoc::Cancelled if a stop has been requested.
+	class SolveContext
+	{
+	public:
+		SolveContext() = default;
+
+		explicit SolveContext(std::stop_token _stopToken, std::function<void(const Progress&)> _onProgress = {})
+			: stopToken(std::move(_stopToken))
+			, onProgress(std::move(_onProgress))
+		{
+		}
+
+		void checkpoint(std::string_view stage, uint64_t done, uint64_t total = 0) const
+		{
+			if (onProgress)
+				onProgress({ stage, done, total });
+
+			if (stopToken.stop_requested())
+				throw Cancelled(stage);
+		}
+
+	private:
+		std::stop_token stopToken;
+		std::function<void(const Progress&)> onProgress;
+	};
+}
@@ -1,6 +1,5 @@
 #include <algorithm>
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <functional>
 #include <map>
@@ -12,21 +11,19 @@
 #include <vector>
 #include <unordered_map>
 
+#include "aoc.h"
+#include "input.h"
+
 namespace d_X_
 {
-	static auto loadData(const char* filename)
+	static auto loadData(std::string_view input)
 	{
-		std::fstream s{ filename, s.in };
-		assert(s.is_open());
-
 		std::vector<std::string> lines;
 
-		while (s.peek() != EOF)
+		for (const std::string_view line : aoc::lines(input))
 		{
-			std::string line;
-			std::getline(s, line);
 			assert(line.size() > 0);
-			lines.push_back(line);
+			lines.emplace_back(line);
 		}
 
 		return lines;
@@ -52,19 +49,19 @@ namespace d_X_
 		);
 	}
 
-	static std::pair<uint64_t, uint64_t> process(const char* filename)
+	static aoc::Answers<> process(std::string_view input)
 	{
-		const auto data = loadData(filename);
-		return std::make_pair(partOne(data), partTwo(data));
+		const auto data = loadData(input);
+		return { partOne(data), partTwo(data) };
 	}
 
 	static void processPrintAndAssert(const char* filename, std::pair<uint64_t, uint64_t> expected)
 	{
-		const auto result = process(filename);
-		std::cout << "Part 1: " << result.first << " Part 2: " << result.second << std::endl;
+		const auto result = process(aoc::readFile(filename));
+		std::cout << "Part 1: " << result.partOne << " Part 2: " << result.partTwo << std::endl;
 
-		assert(expected.first == 0 || result.first == expected.first);
-		assert(expected.second == 0 || result.second == expected.second);
+		assert(expected.first == 0 || result.partOne == expected.first);
+		assert(expected.second == 0 || result.partTwo == expected.second);
 	}
 }
 
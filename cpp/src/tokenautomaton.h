@@ -0,0 +1,355 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace aoc
+{
+	struct Token
+	{
+		std::string_view text;
+		int value = 0;
+	};
+
+	struct TokenMatch
+	{
+		int value = -1; // -1 when there's no match
+		uint32_t length = 0;
+
+		constexpr bool found() const { return value >= 0; }
+	};
+
+	enum class MatchDirection
+	{
+		Forward,
+		Backward // matches the reversed tokens, for scanning text from its end
+	};
+
+	// Of the tokens ending at a position, the longest starts first and the shortest starts last.
+	struct StateOutput
+	{
+		TokenMatch longest;
+		TokenMatch shortest;
+	};
+
+	// Aho-Corasick automaton matching every token of a vocabulary in one left to right pass.
+	//
+	// Failure links are folded into a full transition table, so matching costs the same two
+	// table lookups per input byte whatever the size of the vocabulary. Bytes are first mapped
+	// to classes, one per distinct byte in the vocabulary plus one for all others, which keeps
+	// the table small enough to stay in L1 cache.
+	//
+	// Building allocates, so to keep an automaton as a compile time constant, copy it into a
+	// FixedTokenAutomaton with compileTokenAutomaton().
+	class TokenAutomaton
+	{
+	public:
+		static constexpr uint32_t Start = 0;
+
+		constexpr explicit TokenAutomaton(std::span<const Token> vocabulary, MatchDirection direction = MatchDirection::Forward)
+		{
+			for (const Token& token : vocabulary)
+			{
+				assert(!token.text.empty() && token.value >= 0);
+
+				for (const char c : token.text)
+					if (classOf[(uint8_t) c] == 0)
+						classOf[(uint8_t) c] = (uint8_t) numClasses++;
+
+				maxTokenLength = std::max(maxTokenLength, (uint32_t) token.text.size());
+			}
+
+			assert(numClasses <= 256);
+
+			buildTrie(vocabulary, direction);
+			linkFailures();
+		}
+
+		constexpr uint32_t getNumStates() const { return (uint32_t) outputs.size(); }
+		constexpr uint32_t getNumClasses() const { return numClasses; }
+		constexpr uint32_t getMaxTokenLength() const { return maxTokenLength; }
+
+		constexpr uint32_t step(uint32_t state, char c) const
+		{
+			return transitions[(state * numClasses) + classOf[(uint8_t) c]];
+		}
+
+		constexpr const StateOutput& output(uint32_t state) const { return outputs[state]; }
+
+		constexpr const std::array<uint8_t, 256>& getClasses() const { return classOf; }
+		constexpr const std::vector<uint32_t>& getTransitions() const { return transitions; }
+		constexpr const std::vector<StateOutput>& getOutputs() const { return outputs; }
+
+	private:
+		static constexpr uint32_t NoState = UINT32_MAX;
+
+		constexpr uint32_t addState()
+		{
+			transitions.resize(transitions.size() + numClasses, NoState);
+			outputs.push_back({});
+			return (uint32_t) outputs.size() - 1;
+		}
+
+		constexpr void buildTrie(std::span<const Token> vocabulary, MatchDirection direction)
+		{
+			addState();
+
+			for (const Token& token : vocabulary)
+			{
+				uint32_t state = Start;
+
+				for (size_t i = 0; i < token.text.size(); ++i)
+				{
+					const char c = (direction == MatchDirection::Forward) ? token.text[i] : token.text[token.text.size() - 1 - i];
+					const size_t edge = (state * numClasses) + classOf[(uint8_t) c];
+
+					if (transitions[edge] == NoState)
+					{
+						const uint32_t child = addState();
+						transitions[edge] = child;
+					}
+
+					state = transitions[edge];
+				}
+
+				// Repeated tokens take the last value given.
+				outputs[state].longest = { token.value, (uint32_t) token.text.size() };
+			}
+		}
+
+		// Breadth first, so that each state's failure state, being shallower, is complete before it's needed.
+		constexpr void linkFailures()
+		{
+			std::vector<uint32_t> failure(outputs.size(), Start);
+			std::vector<uint32_t> queue = { Start };
+
+			for (size_t next = 0; next < queue.size(); ++next)
+			{
+				const uint32_t state = queue[next];
+
+				for (uint32_t c = 0; c < numClasses; ++c)
+				{
+					const size_t edge = (state * numClasses) + c;
+					const uint32_t fallback = (state == Start) ? Start : transitions[(failure[state] * numClasses) + c];
+
+					if (transitions[edge] == NoState)
+					{
+						transitions[edge] = fallback;
+						continue;
+					}
+
+					const uint32_t child = transitions[edge];
+					failure[child] = fallback;
+					queue.push_back(child);
+
+					// A child's own token, if it has one, is the longest ending there.
+					// Shorter tokens ending there are those of its failure state.
+					StateOutput& out = outputs[child];
+					const StateOutput& inherited = outputs[fallback];
+
+					if (!out.longest.found())
+						out.longest = inherited.longest;
+
+					out.shortest = inherited.shortest.found() ? inherited.shortest : out.longest;
+				}
+			}
+		}
+
+		std::array<uint8_t, 256> classOf = {}; // class 0 is every byte not in the vocabulary
+		uint32_t numClasses = 1;
+		uint32_t maxTokenLength = 0;
+
+		std::vector<uint32_t> transitions; // [state * numClasses + class]
+		std::vector<StateOutput> outputs;
+	};
+
+	// A TokenAutomaton in fixed size storage, so that it can be kept as a compile time constant.
+	template <uint32_t NumStates, uint32_t NumClasses>
+	class FixedTokenAutomaton
+	{
+	public:
+		static constexpr uint32_t Start = TokenAutomaton::Start;
+
+		constexpr explicit FixedTokenAutomaton(const TokenAutomaton& automaton)
+			: classOf(automaton.getClasses())
+			, maxTokenLength(automaton.getMaxTokenLength())
+		{
+			assert(automaton.getNumStates() == NumStates && automaton.getNumClasses() == NumClasses);
+
+			for (size_t i = 0; i < transitions.size(); ++i)
+				transitions[i] = (uint16_t) automaton.getTransitions()[i];
+
+			std::copy(begin(automaton.getOutputs()), end(automaton.getOutputs()), begin(outputs));
+		}
+
+		constexpr uint32_t getMaxTokenLength() const { return maxTokenLength; }
+
+		constexpr uint32_t step(uint32_t state, char c) const
+		{
+			return transitions[(state * NumClasses) + classOf[(uint8_t) c]];
+		}
+
+		constexpr const StateOutput& output(uint32_t state) const { return outputs[state]; }
+
+	private:
+		std::array<uint8_t, 256> classOf = {};
+		uint32_t maxTokenLength = 0;
+
+		std::array<uint16_t, NumStates * NumClasses> transitions = {};
+		std::array<StateOutput, NumStates> outputs = {};
+
+		static_assert(NumStates <= UINT16_MAX);
+	};
+
+	// Parses a vocabulary of one "text value" pair per line, e.g., "un 1", skipping blank lines.
+	// The tokens' text points into the given text, which must outlive them.
+	constexpr std::vector<Token> parseTokens(std::string_view text)
+	{
+		std::vector<Token> tokens;
+
+		while (!text.empty())
+		{
+			const size_t lineEnd = std::min(text.find('\n'), text.size());
+			std::string_view line = text.substr(0, lineEnd);
+			text.remove_prefix(std::min(lineEnd + 1, text.size()));
+
+			if (!line.empty() && line.back() == '\r')
+				line.remove_suffix(1);
+
+			if (line.empty())
+				continue;
+
+			const size_t separator = line.rfind(' ');
+			assert(separator != std::string_view::npos && separator > 0 && separator + 1 < line.size());
+
+			int value = 0;
+			for (const char c : line.substr(separator + 1))
+			{
+				assert('0' <= c && c <= '9');
+				value = (value * 10) + (c - '0');
+			}
+
+			tokens.push_back({ line.substr(0, separator), value });
+		}
+
+		return tokens;
+	}
+
+	// Compiles a constexpr vocabulary into an automaton at compile time.
+	template <const auto& Vocabulary, MatchDirection Direction = MatchDirection::Forward>
+	consteval auto compileTokenAutomaton()
+	{
+		constexpr uint32_t numStates = TokenAutomaton(Vocabulary, Direction).getNumStates();
+		constexpr uint32_t numClasses = TokenAutomaton(Vocabulary, Direction).getNumClasses();
+
+		return FixedTokenAutomaton<numStates, numClasses>(TokenAutomaton(Vocabulary, Direction));
+	}
+
+	struct FirstAndLastTokens
+	{
+		TokenMatch first;
+		TokenMatch last;
+	};
+
+	// The tokens starting first and last in the text, in one pass over it.
+	// Where several tokens start at the same position, the longest is taken.
+	template <typename Automaton>
+	constexpr FirstAndLastTokens findFirstAndLastTokens(const Automaton& automaton, std::string_view text)
+	{
+		FirstAndLastTokens tokens;
+		size_t firstStart = SIZE_MAX;
+		size_t lastStart = 0;
+
+		uint32_t state = Automaton::Start;
+
+		for (size_t i = 0; i < text.size(); ++i)
+		{
+			state = automaton.step(state, text[i]);
+
+			const StateOutput& out = automaton.output(state);
+			if (!out.longest.found())
+				continue;
+
+			// Tokens detected later can still start earlier when they contain ones detected before them.
+			// Ties on start position go to the later detection, which is the longer token.
+			const size_t longestStart = i + 1 - out.longest.length;
+			if (longestStart <= firstStart)
+			{
+				tokens.first = out.longest;
+				firstStart = longestStart;
+			}
+
+			const size_t shortestStart = i + 1 - out.shortest.length;
+			if (!tokens.last.found() || shortestStart >= lastStart)
+			{
+				tokens.last = out.shortest;
+				lastStart = shortestStart;
+			}
+		}
+
+		return tokens;
+	}
+
+	struct TokenAt
+	{
+		TokenMatch token;
+		size_t position = 0;
+	};
+
+	// The token starting first in the text, scanning forward only as far as needed to be sure of it.
+	// Where several tokens start at the same position, the longest is taken.
+	template <typename Automaton>
+	constexpr TokenAt findFirstToken(const Automaton& automaton, std::string_view text)
+	{
+		TokenAt first;
+		size_t stopAt = text.size();
+
+		uint32_t state = Automaton::Start;
+
+		for (size_t i = 0; i < stopAt; ++i)
+		{
+			state = automaton.step(state, text[i]);
+
+			const StateOutput& out = automaton.output(state);
+			if (!out.longest.found())
+				continue;
+
+			const size_t start = i + 1 - out.longest.length;
+			if (!first.token.found() || start <= first.position)
+			{
+				first = { out.longest, start };
+
+				// Tokens starting at or before this one must end within the longest token length of it.
+				stopAt = std::min(text.size(), start + automaton.getMaxTokenLength());
+			}
+		}
+
+		return first;
+	}
+
+	// The token starting last in the text, scanning backward from its end with an automaton
+	// compiled with MatchDirection::Backward, and stopping at the first match.
+	// Where several tokens start at the same position, the longest is taken.
+	template <typename Automaton>
+	constexpr TokenAt findLastToken(const Automaton& reversedAutomaton, std::string_view text)
+	{
+		uint32_t state = Automaton::Start;
+
+		for (size_t i = text.size(); i-- > 0;)
+		{
+			state = reversedAutomaton.step(state, text[i]);
+
+			// Reversed tokens ending here are tokens starting here, and all of them have been seen.
+			const StateOutput& out = reversedAutomaton.output(state);
+			if (out.longest.found())
+				return { out.longest, i };
+		}
+
+		return {};
+	}
+}